@@ -0,0 +1,778 @@
+/**
+ * Ljos Standard Library - Async File I/O Engine (C++ Runtime)
+ * 异步文件 I/O 引擎：Linux 上直接使用 io_uring，不可用时退回线程池
+ */
+
+#ifndef LJOS_STD_AIO_HPP
+#define LJOS_STD_AIO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define LJOS_AIO_POSIX 1
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register) && \
+    defined(IORING_FEAT_RW_CUR_POS)
+#define LJOS_AIO_URING 1
+#endif
+#endif
+#endif
+
+#if defined(LJOS_AIO_POSIX)
+
+namespace ljos {
+namespace aio {
+
+// ============ 请求 ============
+
+// 完成回调：参数为传输的字节数，失败时为 -errno
+using Callback = std::function<void(long)>;
+
+enum class OpCode {
+    Nop,
+    Read,
+    Write,
+    ReadFixed,   // 读入已注册缓冲区
+    WriteFixed,  // 从已注册缓冲区写出
+    Fsync,
+    Fdatasync,
+};
+
+// 一次 I/O 请求；单个请求的长度受内核限制（约 2 GiB）
+struct Request {
+    OpCode op = OpCode::Nop;
+    int fd = -1;
+    void* buf = nullptr;
+    size_t len = 0;
+    uint64_t offset = 0;
+    int bufIndex = -1;  // 已注册缓冲区下标（ReadFixed / WriteFixed）
+    Callback done;
+};
+
+namespace detail {
+
+// 同步执行一个请求（线程池后端使用）
+inline long perform(const Request& req) {
+    for (;;) {
+        ssize_t n = 0;
+        switch (req.op) {
+            case OpCode::Nop:
+                return 0;
+            case OpCode::Read:
+            case OpCode::ReadFixed:
+                n = ::pread(req.fd, req.buf, req.len, static_cast<off_t>(req.offset));
+                break;
+            case OpCode::Write:
+            case OpCode::WriteFixed:
+                n = ::pwrite(req.fd, req.buf, req.len, static_cast<off_t>(req.offset));
+                break;
+            case OpCode::Fsync:
+                n = ::fsync(req.fd);
+                break;
+            case OpCode::Fdatasync:
+#if defined(__linux__)
+                n = ::fdatasync(req.fd);
+#else
+                n = ::fsync(req.fd);
+#endif
+                break;
+        }
+        if (n >= 0) return static_cast<long>(n);
+        if (errno != EINTR) return -static_cast<long>(errno);
+    }
+}
+
+// 完成请求并调用回调
+inline void complete(Request& req, long result) {
+    if (req.done) req.done(result);
+}
+
+// ============ 线程池后端 ============
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads) {
+        if (threads == 0) threads = 1;
+        workers_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { run(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 退出前执行完队列中剩余的请求
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    void submit(std::vector<Request>& batch) {
+        if (batch.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& req : batch) queue_.push_back(std::move(req));
+        }
+        if (batch.size() == 1) {
+            ready_.notify_one();
+        } else {
+            ready_.notify_all();
+        }
+        batch.clear();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            Request req;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) return;
+                req = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            complete(req, perform(req));
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+#if defined(LJOS_AIO_URING)
+
+// ============ io_uring 后端 ============
+// 不依赖 liburing：直接通过系统调用建立环形队列。
+// 提交方持锁填写 SQ 并一次 io_uring_enter 提交整批请求，
+// 后台收割线程等待 CQ 并回调完成函数。
+//   - 在途请求放在固定数量的槽位中，数量不超过 CQ 容量，CQ 不会溢出；
+//     槽位用完时提交方先把已填写的条目交给内核，再等待收割线程释放槽位
+//   - 收割线程从不提交：完成回调里再次提交的请求（如短读的续读）交给转交线程
+//   - io_uring_enter 出现不可恢复的错误时，相关请求以 -errno 完成，不会一直挂起
+
+class Uring {
+public:
+    // 内核不支持或被禁用（seccomp、容器策略等）时返回 nullptr
+    static std::unique_ptr<Uring> create(unsigned entries) {
+        std::unique_ptr<Uring> ring(new Uring());
+        if (!ring->setup(entries)) return nullptr;
+        ring->reaper_ = std::thread([r = ring.get()] { r->reap(); });
+        ring->resubmitter_ = std::thread([r = ring.get()] { r->resubmit(); });
+        return ring;
+    }
+
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    // 等待所有在途及转交中的请求完成后再关闭
+    ~Uring() {
+        if (reaper_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(submitMutex_);
+                stopping_ = true;
+                if (error_ == 0) wake();
+            }
+            reaper_.join();
+        }
+        if (resubmitter_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(deferredMutex_);
+                deferredStop_ = true;
+            }
+            deferredReady_.notify_one();
+            resubmitter_.join();
+        }
+        if (sqes_ != MAP_FAILED) ::munmap(sqes_, sqesSize_);
+        if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) ::munmap(cqRing_, cqRingSize_);
+        if (sqRing_ != MAP_FAILED) ::munmap(sqRing_, sqRingSize_);
+        if (ringFd_ >= 0) ::close(ringFd_);
+    }
+
+    // 批量提交：整批只进入内核一次（SQ 填满或槽位用完时才中途提交）
+    void submit(std::vector<Request>& batch) {
+        if (std::this_thread::get_id() == reaper_.get_id()) {
+            defer(batch);
+            return;
+        }
+        submit(batch, false);
+    }
+
+    // 注册固定缓冲区（受 RLIMIT_MEMLOCK 限制，失败时返回 false）
+    bool registerBuffers(const std::vector<iovec>& buffers) {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        if (registered_) {
+            ::syscall(__NR_io_uring_register, ringFd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            registered_ = false;
+        }
+        if (buffers.empty()) return true;
+        long ret = ::syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_BUFFERS,
+                             buffers.data(), static_cast<unsigned>(buffers.size()));
+        registered_ = ret == 0;
+        return registered_;
+    }
+
+    bool hasRegisteredBuffers() const { return registered_; }
+
+private:
+    // 以错误结束、需在释放锁后回调的请求
+    using Failed = std::vector<std::pair<Request, long>>;
+
+    Uring() = default;
+
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CLAMP;
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) return false;
+        ringFd_ = fd;
+        // 需要 IORING_OP_READ/WRITE（5.6+，与 RW_CUR_POS 同时引入）以及不丢弃完成事件
+        const unsigned required = IORING_FEAT_NODROP | IORING_FEAT_RW_CUR_POS;
+        if ((params.features & required) != required) return false;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) return false;
+        if (singleMmap) {
+            cqRing_ = sqRing_;
+        } else {
+            cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             fd, IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) return false;
+        }
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<char*>(sqRing_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqEntries_ = params.sq_entries;
+
+        auto* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        // 留一个 CQ 位置给关闭时的唤醒请求
+        unsigned slots = std::max(1u, params.cq_entries - 1);
+        slots_.resize(slots);
+        used_.assign(slots, false);
+        freeSlots_.reserve(slots);
+        for (unsigned i = slots; i > 0; --i) freeSlots_.push_back(i - 1);
+        return true;
+    }
+
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete,
+                                          flags, nullptr, 0));
+    }
+
+    static bool transient(int err) {
+        return err == EINTR || err == EAGAIN || err == EBUSY;
+    }
+
+    void submit(std::vector<Request>& batch, bool deferred) {
+        Failed failed;
+        {
+            std::unique_lock<std::mutex> lock(submitMutex_);
+            for (auto& req : batch) {
+                if (error_ == 0 && *sqTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+                    flush(failed);
+                }
+                if (error_ == 0 && freeSlots_.empty()) {
+                    // 先交出已填写的条目，否则收割线程等不到可以释放的槽位
+                    flush(failed);
+                    capacity_.wait(lock, [this] { return error_ != 0 || !freeSlots_.empty(); });
+                }
+                if (deferred) --deferredCount_;
+                if (error_ != 0) {
+                    failed.emplace_back(std::move(req), error_);
+                    continue;
+                }
+                unsigned slot = freeSlots_.back();
+                freeSlots_.pop_back();
+                slots_[slot] = std::move(req);
+                used_[slot] = true;
+
+                unsigned tail = *sqTail_;
+                unsigned index = tail & *sqMask_;
+                io_uring_sqe* sqe = &sqes_[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                prepare(sqe, slots_[slot], slot + 1);
+                sqArray_[index] = index;
+                __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+            }
+            if (error_ == 0) flush(failed);
+        }
+        if (!failed.empty()) capacity_.notify_all();
+        for (auto& [req, result] : failed) complete(req, result);
+        batch.clear();
+    }
+
+    // 提交一个空请求唤醒收割线程（调用方持有 submitMutex_）
+    void wake() {
+        unsigned tail = *sqTail_;
+        unsigned index = tail & *sqMask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = 0;
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        Failed failed;
+        flush(failed);
+    }
+
+    // 收割线程不能自己提交（可能要等它自己才能释放的槽位），改由转交线程提交
+    void defer(std::vector<Request>& batch) {
+        {
+            std::lock_guard<std::mutex> lock(submitMutex_);
+            deferredCount_ += batch.size();
+        }
+        {
+            std::lock_guard<std::mutex> lock(deferredMutex_);
+            for (auto& req : batch) deferred_.push_back(std::move(req));
+        }
+        deferredReady_.notify_one();
+        batch.clear();
+    }
+
+    void resubmit() {
+        std::unique_lock<std::mutex> lock(deferredMutex_);
+        for (;;) {
+            deferredReady_.wait(lock, [this] { return deferredStop_ || !deferred_.empty(); });
+            if (deferred_.empty()) return;
+            std::vector<Request> batch;
+            batch.swap(deferred_);
+            lock.unlock();
+            submit(batch, true);
+            lock.lock();
+        }
+    }
+
+    void prepare(io_uring_sqe* sqe, const Request& req, uint64_t userData) {
+        sqe->fd = req.fd;
+        sqe->addr = reinterpret_cast<uint64_t>(req.buf);
+        sqe->len = static_cast<uint32_t>(req.len);
+        sqe->off = req.offset;
+        sqe->user_data = userData;
+        switch (req.op) {
+            case OpCode::Nop: sqe->opcode = IORING_OP_NOP; break;
+            case OpCode::Read: sqe->opcode = IORING_OP_READ; break;
+            case OpCode::Write: sqe->opcode = IORING_OP_WRITE; break;
+            case OpCode::ReadFixed:
+                sqe->opcode = IORING_OP_READ_FIXED;
+                sqe->buf_index = static_cast<uint16_t>(req.bufIndex);
+                break;
+            case OpCode::WriteFixed:
+                sqe->opcode = IORING_OP_WRITE_FIXED;
+                sqe->buf_index = static_cast<uint16_t>(req.bufIndex);
+                break;
+            case OpCode::Fsync:
+                sqe->opcode = IORING_OP_FSYNC;
+                break;
+            case OpCode::Fdatasync:
+                sqe->opcode = IORING_OP_FSYNC;
+                sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+                break;
+        }
+    }
+
+    // 把 SQ 中尚未提交的条目交给内核（调用方持有 submitMutex_）。
+    // 不可恢复的错误时撤回这些条目（未使用 SQPOLL，内核只在 enter 时读取 SQ），
+    // 对应请求以 -errno 放入 failed
+    void flush(Failed& failed) {
+        for (;;) {
+            unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+            unsigned tail = *sqTail_;
+            if (head == tail) return;
+            if (enter(tail - head, 0, 0) >= 0 || transient(errno)) {
+                if (__atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) == head) std::this_thread::yield();
+                continue;
+            }
+            long error = -static_cast<long>(errno);
+            for (unsigned i = head; i != tail; ++i) {
+                uint64_t data = sqes_[sqArray_[i & *sqMask_]].user_data;
+                if (data != 0) failed.emplace_back(release(static_cast<unsigned>(data - 1)), error);
+            }
+            __atomic_store_n(sqTail_, head, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+
+    // 取出槽位中的请求并归还槽位（调用方持有 submitMutex_）
+    Request release(unsigned slot) {
+        Request req = std::move(slots_[slot]);
+        used_[slot] = false;
+        freeSlots_.push_back(slot);
+        return req;
+    }
+
+    bool idle() const {
+        return freeSlots_.size() == slots_.size() && deferredCount_ == 0;
+    }
+
+    void reap() {
+        Failed done;
+        for (;;) {
+            unsigned head = *cqHead_;
+            unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                {
+                    std::lock_guard<std::mutex> lock(submitMutex_);
+                    if (stopping_ && idle()) return;
+                }
+                if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && !transient(errno)) {
+                    abandon(-static_cast<long>(errno));
+                    return;
+                }
+                continue;
+            }
+            {
+                std::lock_guard<std::mutex> lock(submitMutex_);
+                for (; head != tail; ++head) {
+                    const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+                    if (cqe.user_data == 0) continue;  // 唤醒用的空请求
+                    done.emplace_back(release(static_cast<unsigned>(cqe.user_data - 1)), cqe.res);
+                }
+                __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+            }
+            capacity_.notify_all();
+            for (auto& [req, result] : done) complete(req, result);
+            done.clear();
+        }
+    }
+
+    // 收割失败后再也拿不到完成事件：在途请求全部以 error 完成，之后的提交直接失败
+    void abandon(long error) {
+        Failed failed;
+        {
+            std::lock_guard<std::mutex> lock(submitMutex_);
+            error_ = error;
+            for (unsigned slot = 0; slot < slots_.size(); ++slot) {
+                if (used_[slot]) failed.emplace_back(release(slot), error);
+            }
+        }
+        capacity_.notify_all();
+        for (auto& [req, result] : failed) complete(req, result);
+    }
+
+    int ringFd_ = -1;
+    void* sqRing_ = MAP_FAILED;
+    void* cqRing_ = MAP_FAILED;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqMask_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqEntries_ = 0;
+
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned* cqMask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+
+    // 以下由 submitMutex_ 保护；user_data 为槽位下标 + 1，0 表示唤醒请求
+    std::mutex submitMutex_;
+    std::condition_variable capacity_;
+    std::vector<Request> slots_;
+    std::vector<bool> used_;
+    std::vector<unsigned> freeSlots_;
+    size_t deferredCount_ = 0;  // 已转交、尚未占用槽位的请求
+    long error_ = 0;            // 收割失败后的错误码（-errno）
+    bool stopping_ = false;
+    bool registered_ = false;
+
+    std::mutex deferredMutex_;
+    std::condition_variable deferredReady_;
+    std::vector<Request> deferred_;
+    bool deferredStop_ = false;
+
+    std::thread reaper_;
+    std::thread resubmitter_;
+};
+
+#endif // LJOS_AIO_URING
+
+// 把回调请求转换为返回 future 的请求
+inline std::future<long> attachPromise(Request& req) {
+    auto promise = std::make_shared<std::promise<long>>();
+    std::future<long> future = promise->get_future();
+    req.done = [promise](long result) { promise->set_value(result); };
+    return future;
+}
+
+} // namespace detail
+
+// ============ 引擎 ============
+
+class Batch;
+
+class Engine {
+public:
+    // entries: io_uring 队列深度；useIoUring 为 false 时强制使用线程池
+    explicit Engine(unsigned entries = 256, bool useIoUring = true) {
+#if defined(LJOS_AIO_URING)
+        if (useIoUring) uring_ = detail::Uring::create(entries);
+#else
+        (void)entries;
+        (void)useIoUring;
+#endif
+        if (!usingIoUring()) {
+            unsigned threads = std::max(4u, std::thread::hardware_concurrency());
+            pool_ = std::make_unique<detail::ThreadPool>(threads);
+        }
+    }
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // 进程级默认引擎（首次使用时创建）
+    static Engine& instance() {
+        static Engine engine;
+        return engine;
+    }
+
+    bool usingIoUring() const {
+#if defined(LJOS_AIO_URING)
+        return uring_ != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    // 提交单个请求，完成时调用 req.done
+    void submit(Request req) {
+        std::vector<Request> batch;
+        batch.push_back(std::move(req));
+        submit(batch);
+    }
+
+    // 批量提交（io_uring 下只需一次系统调用），提交后 batch 被清空
+    void submit(std::vector<Request>& batch) {
+        for (auto& req : batch) resolveFixed(req);
+#if defined(LJOS_AIO_URING)
+        if (uring_) {
+            uring_->submit(batch);
+            return;
+        }
+#endif
+        pool_->submit(batch);
+    }
+
+    std::future<long> read(int fd, void* buf, size_t len, uint64_t offset) {
+        return submitWithFuture(makeRequest(OpCode::Read, fd, buf, len, offset));
+    }
+
+    std::future<long> write(int fd, const void* buf, size_t len, uint64_t offset) {
+        return submitWithFuture(makeRequest(OpCode::Write, fd, const_cast<void*>(buf), len, offset));
+    }
+
+    std::future<long> fsync(int fd, bool dataOnly = false) {
+        return submitWithFuture(makeRequest(dataOnly ? OpCode::Fdatasync : OpCode::Fsync, fd, nullptr, 0, 0));
+    }
+
+    // 读入第 bufIndex 个已注册缓冲区的开头
+    std::future<long> readFixed(int fd, int bufIndex, size_t len, uint64_t offset) {
+        Request req = makeRequest(OpCode::ReadFixed, fd, nullptr, len, offset);
+        req.bufIndex = bufIndex;
+        return submitWithFuture(std::move(req));
+    }
+
+    std::future<long> writeFixed(int fd, int bufIndex, size_t len, uint64_t offset) {
+        Request req = makeRequest(OpCode::WriteFixed, fd, nullptr, len, offset);
+        req.bufIndex = bufIndex;
+        return submitWithFuture(std::move(req));
+    }
+
+    // 注册固定缓冲区：io_uring 下内核预先固定这些页，省去每次请求的页表映射。
+    // 注册失败（如 memlock 限制）时缓冲区仍可使用，只是退化为普通读写。
+    bool registerBuffers(const std::vector<std::pair<void*, size_t>>& buffers) {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        buffers_.clear();
+        for (const auto& b : buffers) {
+            iovec iov;
+            iov.iov_base = b.first;
+            iov.iov_len = b.second;
+            buffers_.push_back(iov);
+        }
+#if defined(LJOS_AIO_URING)
+        if (uring_) return uring_->registerBuffers(buffers_);
+#endif
+        return false;
+    }
+
+    void unregisterBuffers() { registerBuffers({}); }
+
+    void* buffer(int index) const {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        if (index < 0 || static_cast<size_t>(index) >= buffers_.size()) return nullptr;
+        return buffers_[static_cast<size_t>(index)].iov_base;
+    }
+
+    inline Batch batch();
+
+private:
+    static Request makeRequest(OpCode op, int fd, void* buf, size_t len, uint64_t offset) {
+        Request req;
+        req.op = op;
+        req.fd = fd;
+        req.buf = buf;
+        req.len = len;
+        req.offset = offset;
+        return req;
+    }
+
+    std::future<long> submitWithFuture(Request req) {
+        std::future<long> future = detail::attachPromise(req);
+        submit(std::move(req));
+        return future;
+    }
+
+    // 把固定缓冲区下标解析为地址；未注册到内核时改为普通读写
+    void resolveFixed(Request& req) {
+        if (req.op != OpCode::ReadFixed && req.op != OpCode::WriteFixed) return;
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        if (req.bufIndex < 0 || static_cast<size_t>(req.bufIndex) >= buffers_.size()) {
+            // 无效下标：以 NOP 提交，由回调包装器报告 -EINVAL
+            Callback done = std::move(req.done);
+            req.op = OpCode::Nop;
+            req.done = [done](long) { if (done) done(-EINVAL); };
+            return;
+        }
+        const iovec& iov = buffers_[static_cast<size_t>(req.bufIndex)];
+        req.buf = iov.iov_base;
+        req.len = std::min(req.len, iov.iov_len);
+#if defined(LJOS_AIO_URING)
+        if (uring_ && uring_->hasRegisteredBuffers()) return;
+#endif
+        req.op = req.op == OpCode::ReadFixed ? OpCode::Read : OpCode::Write;
+    }
+
+#if defined(LJOS_AIO_URING)
+    std::unique_ptr<detail::Uring> uring_;
+#endif
+    std::unique_ptr<detail::ThreadPool> pool_;
+    mutable std::mutex buffersMutex_;
+    std::vector<iovec> buffers_;
+};
+
+// ============ 批量提交 ============
+
+// 收集多个请求后一次提交；析构时自动提交尚未提交的请求
+class Batch {
+public:
+    explicit Batch(Engine& engine = Engine::instance()) : engine_(engine) {}
+
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+    Batch(Batch&&) = default;
+
+    ~Batch() { submit(); }
+
+    // 添加回调式请求
+    void add(Request req) { requests_.push_back(std::move(req)); }
+
+    std::future<long> read(int fd, void* buf, size_t len, uint64_t offset) {
+        return addWithFuture(OpCode::Read, fd, buf, len, offset);
+    }
+
+    std::future<long> write(int fd, const void* buf, size_t len, uint64_t offset) {
+        return addWithFuture(OpCode::Write, fd, const_cast<void*>(buf), len, offset);
+    }
+
+    std::future<long> fsync(int fd, bool dataOnly = false) {
+        return addWithFuture(dataOnly ? OpCode::Fdatasync : OpCode::Fsync, fd, nullptr, 0, 0);
+    }
+
+    std::future<long> readFixed(int fd, int bufIndex, size_t len, uint64_t offset) {
+        return addWithFuture(OpCode::ReadFixed, fd, nullptr, len, offset, bufIndex);
+    }
+
+    std::future<long> writeFixed(int fd, int bufIndex, size_t len, uint64_t offset) {
+        return addWithFuture(OpCode::WriteFixed, fd, nullptr, len, offset, bufIndex);
+    }
+
+    size_t size() const { return requests_.size(); }
+
+    void submit() {
+        if (!requests_.empty()) engine_.submit(requests_);
+    }
+
+private:
+    std::future<long> addWithFuture(OpCode op, int fd, void* buf, size_t len, uint64_t offset,
+                                    int bufIndex = -1) {
+        Request req;
+        req.op = op;
+        req.fd = fd;
+        req.buf = buf;
+        req.len = len;
+        req.offset = offset;
+        req.bufIndex = bufIndex;
+        std::future<long> future = detail::attachPromise(req);
+        requests_.push_back(std::move(req));
+        return future;
+    }
+
+    Engine& engine_;
+    std::vector<Request> requests_;
+};
+
+inline Batch Engine::batch() {
+    return Batch(*this);
+}
+
+} // namespace aio
+} // namespace ljos
+
+#endif // LJOS_AIO_POSIX
+
+#endif // LJOS_STD_AIO_HPP
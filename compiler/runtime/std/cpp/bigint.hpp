@@ -0,0 +1,552 @@
+/**
+ * Ljos Standard Library - BigInt (C++ Runtime)
+ * 任意精度整数：符号 + 10^9 进制 limb 数组（低位在前）。
+ * 十进制 limb 让字符串转换是线性的；大数乘法切换到 Karatsuba。
+ */
+
+#ifndef LJOS_STD_BIGINT_HPP
+#define LJOS_STD_BIGINT_HPP
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ljos {
+namespace math {
+
+namespace detail {
+
+using Limbs = std::vector<uint32_t>;
+
+constexpr uint32_t BIG_BASE = 1000000000u;
+constexpr size_t BIG_BASE_DIGITS = 9;
+
+// 双方都不少于这么多 limb 时才用 Karatsuba，更小的规模 O(n^2) 的常数更低
+constexpr size_t KARATSUBA_THRESHOLD = 32;
+
+inline size_t trimmedSize(const uint32_t* a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) n--;
+    return n;
+}
+
+inline void trim(Limbs& a) {
+    a.resize(trimmedSize(a.data(), a.size()));
+}
+
+// 比较两个已去掉前导零的绝对值
+inline int compareMag(const Limbs& a, const Limbs& b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// r += x · BASE^shift，r 按需增长
+inline void addAt(Limbs& r, const uint32_t* x, size_t nx, size_t shift) {
+    nx = trimmedSize(x, nx);
+    if (r.size() < shift + nx) r.resize(shift + nx, 0);
+    uint32_t carry = 0;
+    for (size_t i = 0; i < nx; i++) {
+        uint32_t s = r[shift + i] + x[i] + carry;
+        carry = s >= BIG_BASE;
+        r[shift + i] = carry ? s - BIG_BASE : s;
+    }
+    for (size_t j = shift + nx; carry; j++) {
+        if (j == r.size()) r.push_back(0);
+        uint32_t s = r[j] + 1;
+        carry = s == BIG_BASE;
+        r[j] = carry ? 0 : s;
+    }
+}
+
+// r -= x · BASE^shift，调用方保证结果非负
+inline void subAt(Limbs& r, const uint32_t* x, size_t nx, size_t shift) {
+    nx = trimmedSize(x, nx);
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < nx; i++) {
+        int64_t d = static_cast<int64_t>(r[shift + i]) - x[i] - borrow;
+        borrow = d < 0;
+        r[shift + i] = static_cast<uint32_t>(borrow ? d + BIG_BASE : d);
+    }
+    for (size_t j = shift + nx; borrow; j++) {
+        borrow = r[j] == 0;
+        r[j] = borrow ? BIG_BASE - 1 : r[j] - 1;
+    }
+}
+
+// out[0, na + nb) 需预先清零
+inline void mulSchool(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    for (size_t i = 0; i < na; i++) {
+        uint64_t ai = a[i];
+        if (ai == 0) continue;
+        uint64_t carry = 0;
+        for (size_t j = 0; j < nb; j++) {
+            uint64_t cur = out[i + j] + ai * b[j] + carry;
+            out[i + j] = static_cast<uint32_t>(cur % BIG_BASE);
+            carry = cur / BIG_BASE;
+        }
+        out[i + nb] = static_cast<uint32_t>(carry);
+    }
+}
+
+inline Limbs mulMag(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+    na = trimmedSize(a, na);
+    nb = trimmedSize(b, nb);
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    Limbs out;
+    if (nb == 0) return out;
+
+    if (nb < KARATSUBA_THRESHOLD) {
+        out.assign(na + nb, 0);
+        mulSchool(a, na, b, nb, out.data());
+        trim(out);
+        return out;
+    }
+
+    // 长短悬殊时把长的一方按短的一方的长度切块，每块都是平衡的乘法
+    if (2 * nb <= na) {
+        for (size_t i = 0; i < na; i += nb) {
+            Limbs part = mulMag(a + i, std::min(nb, na - i), b, nb);
+            addAt(out, part.data(), part.size(), i);
+        }
+        trim(out);
+        return out;
+    }
+
+    // a = a1·B^m + a0，b = b1·B^m + b0，
+    // a·b = z2·B^2m + ((a0 + a1)(b0 + b1) - z2 - z0)·B^m + z0
+    size_t m = na / 2;
+    Limbs z0 = mulMag(a, m, b, m);
+    Limbs z2 = mulMag(a + m, na - m, b + m, nb - m);
+
+    Limbs sa(a, a + m);
+    addAt(sa, a + m, na - m, 0);
+    Limbs sb(b, b + m);
+    addAt(sb, b + m, nb - m, 0);
+    Limbs z1 = mulMag(sa.data(), sa.size(), sb.data(), sb.size());
+    subAt(z1, z0.data(), z0.size(), 0);
+    subAt(z1, z2.data(), z2.size(), 0);
+
+    out = std::move(z0);
+    addAt(out, z1.data(), z1.size(), m);
+    addAt(out, z2.data(), z2.size(), 2 * m);
+    trim(out);
+    return out;
+}
+
+// a *= m（m < BASE）
+inline void mulSmall(Limbs& a, uint32_t m) {
+    uint64_t carry = 0;
+    for (uint32_t& limb : a) {
+        uint64_t cur = static_cast<uint64_t>(limb) * m + carry;
+        limb = static_cast<uint32_t>(cur % BIG_BASE);
+        carry = cur / BIG_BASE;
+    }
+    if (carry) a.push_back(static_cast<uint32_t>(carry));
+    trim(a);
+}
+
+// a /= d（0 < d < BASE），返回余数
+inline uint32_t divSmall(Limbs& a, uint32_t d) {
+    uint64_t rem = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        uint64_t cur = rem * BIG_BASE + a[i];
+        a[i] = static_cast<uint32_t>(cur / d);
+        rem = cur % d;
+    }
+    trim(a);
+    return static_cast<uint32_t>(rem);
+}
+
+// Knuth 算法 D：u = q·v + r，v 非零
+inline void divModMag(const Limbs& u, const Limbs& v, Limbs& q, Limbs& r) {
+    if (compareMag(u, v) < 0) {
+        q.clear();
+        r = u;
+        return;
+    }
+    if (v.size() == 1) {
+        q = u;
+        uint32_t rem = divSmall(q, v[0]);
+        r.assign(rem ? 1 : 0, rem);
+        return;
+    }
+
+    // 归一化：让除数最高位不小于 BASE / 2，试商最多偏大 2
+    uint32_t scale = BIG_BASE / (v.back() + 1);
+    Limbs un = u;
+    Limbs vn = v;
+    un.push_back(0);
+    if (scale > 1) {
+        mulSmall(un, scale);
+        mulSmall(vn, scale);
+        un.resize(u.size() + 1, 0);
+    }
+
+    size_t n = vn.size();
+    size_t m = un.size() - n;
+    uint64_t vTop = vn[n - 1];
+    uint64_t vNext = vn[n - 2];
+    q.assign(m, 0);
+
+    for (size_t j = m; j-- > 0;) {
+        uint64_t num = static_cast<uint64_t>(un[j + n]) * BIG_BASE + un[j + n - 1];
+        uint64_t qhat = num / vTop;
+        uint64_t rhat = num % vTop;
+        while (qhat >= BIG_BASE || qhat * vNext > rhat * BIG_BASE + un[j + n - 2]) {
+            qhat--;
+            rhat += vTop;
+            if (rhat >= BIG_BASE) break;
+        }
+
+        // un[j, j + n] -= qhat · vn
+        uint64_t carry = 0;
+        int64_t borrow = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t p = qhat * vn[i] + carry;
+            carry = p / BIG_BASE;
+            int64_t t = static_cast<int64_t>(un[i + j]) - static_cast<int64_t>(p % BIG_BASE) - borrow;
+            borrow = t < 0;
+            un[i + j] = static_cast<uint32_t>(borrow ? t + BIG_BASE : t);
+        }
+        int64_t top = static_cast<int64_t>(un[j + n]) - static_cast<int64_t>(carry) - borrow;
+
+        if (top < 0) {
+            // 试商大了 1：加回一个除数，最高位的进位与借位抵消
+            qhat--;
+            uint32_t c = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint32_t s = un[i + j] + vn[i] + c;
+                c = s >= BIG_BASE;
+                un[i + j] = c ? s - BIG_BASE : s;
+            }
+            top += BIG_BASE + c;
+            top %= BIG_BASE;
+        }
+        un[j + n] = static_cast<uint32_t>(top);
+        q[j] = static_cast<uint32_t>(qhat);
+    }
+
+    trim(q);
+    un.resize(n);
+    trim(un);
+    if (scale > 1) divSmall(un, scale);
+    r = std::move(un);
+}
+
+} // namespace detail
+
+// ============ BigInt ============
+
+class BigInt {
+public:
+    BigInt() = default;
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    BigInt(T value) {
+        unsigned long long mag;
+        if constexpr (std::is_signed_v<T>) {
+            negative_ = value < 0;
+            // 先转无符号再取负，LLONG_MIN 也不会溢出
+            mag = negative_ ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+        } else {
+            mag = value;
+        }
+        while (mag != 0) {
+            limbs_.push_back(static_cast<uint32_t>(mag % detail::BIG_BASE));
+            mag /= detail::BIG_BASE;
+        }
+    }
+
+    // 十进制字符串，可带 +/- 号；格式不合法时返回空
+    static std::optional<BigInt> parse(std::string_view s) {
+        bool negative = false;
+        if (!s.empty() && (s[0] == '+' || s[0] == '-')) {
+            negative = s[0] == '-';
+            s.remove_prefix(1);
+        }
+        if (s.empty()) return std::nullopt;
+
+        BigInt result;
+        result.limbs_.reserve(s.size() / detail::BIG_BASE_DIGITS + 1);
+        for (size_t end = s.size(); end > 0;) {
+            size_t start = end > detail::BIG_BASE_DIGITS ? end - detail::BIG_BASE_DIGITS : 0;
+            uint32_t limb = 0;
+            for (size_t i = start; i < end; i++) {
+                if (s[i] < '0' || s[i] > '9') return std::nullopt;
+                limb = limb * 10 + static_cast<uint32_t>(s[i] - '0');
+            }
+            result.limbs_.push_back(limb);
+            end = start;
+        }
+        detail::trim(result.limbs_);
+        result.negative_ = negative && !result.limbs_.empty();
+        return result;
+    }
+
+    std::string toString() const {
+        if (limbs_.empty()) return "0";
+        std::string out;
+        out.reserve(limbs_.size() * detail::BIG_BASE_DIGITS + 1);
+        if (negative_) out.push_back('-');
+        out += std::to_string(limbs_.back());
+        char buf[detail::BIG_BASE_DIGITS];
+        for (size_t i = limbs_.size() - 1; i-- > 0;) {
+            uint32_t limb = limbs_[i];
+            for (size_t k = detail::BIG_BASE_DIGITS; k-- > 0;) {
+                buf[k] = static_cast<char>('0' + limb % 10);
+                limb /= 10;
+            }
+            out.append(buf, detail::BIG_BASE_DIGITS);
+        }
+        return out;
+    }
+
+    // 超出 long long 范围时返回空
+    std::optional<long long> toInt() const {
+        unsigned long long mag = 0;
+        for (size_t i = limbs_.size(); i-- > 0;) {
+            if (mag > (ULLONG_MAX - limbs_[i]) / detail::BIG_BASE) return std::nullopt;
+            mag = mag * detail::BIG_BASE + limbs_[i];
+        }
+        if (negative_) {
+            if (mag > static_cast<unsigned long long>(LLONG_MAX) + 1) return std::nullopt;
+            return static_cast<long long>(0ULL - mag);
+        }
+        if (mag > static_cast<unsigned long long>(LLONG_MAX)) return std::nullopt;
+        return static_cast<long long>(mag);
+    }
+
+    // 最接近的 double（只取最高三个 limb，超出范围为 ±inf）
+    double toFloat() const {
+        double result = 0.0;
+        size_t n = limbs_.size();
+        size_t low = n > 3 ? n - 3 : 0;
+        for (size_t i = n; i-- > low;) result = result * detail::BIG_BASE + limbs_[i];
+        for (size_t i = 0; i < low; i++) result *= detail::BIG_BASE;
+        return negative_ ? -result : result;
+    }
+
+    bool isZero() const { return limbs_.empty(); }
+    bool isNegative() const { return negative_; }
+    int sign() const { return limbs_.empty() ? 0 : (negative_ ? -1 : 1); }
+
+    // 十进制位数（不含符号，0 为 1 位）
+    size_t digits() const {
+        if (limbs_.empty()) return 1;
+        size_t top = 0;
+        for (uint32_t v = limbs_.back(); v != 0; v /= 10) top++;
+        return (limbs_.size() - 1) * detail::BIG_BASE_DIGITS + top;
+    }
+
+    BigInt abs() const {
+        BigInt r = *this;
+        r.negative_ = false;
+        return r;
+    }
+
+    // ============ 算术运算 ============
+
+    BigInt operator-() const {
+        BigInt r = *this;
+        r.negative_ = !r.negative_ && !r.limbs_.empty();
+        return r;
+    }
+
+    BigInt& operator+=(const BigInt& other) { return addSigned(other, other.negative_); }
+    BigInt& operator-=(const BigInt& other) { return addSigned(other, !other.negative_); }
+
+    BigInt& operator*=(const BigInt& other) {
+        limbs_ = detail::mulMag(limbs_.data(), limbs_.size(), other.limbs_.data(), other.limbs_.size());
+        negative_ = !limbs_.empty() && negative_ != other.negative_;
+        return *this;
+    }
+
+    // 截断除法（向零取整，余数与被除数同号），与 C++ 整数一致；
+    // 运行时不抛异常，除以零时商为 0、余数为被除数
+    BigInt& operator/=(const BigInt& other) {
+        BigInt q, r;
+        divMod(*this, other, q, r);
+        return *this = std::move(q);
+    }
+
+    BigInt& operator%=(const BigInt& other) {
+        BigInt q, r;
+        divMod(*this, other, q, r);
+        return *this = std::move(r);
+    }
+
+    BigInt& operator++() { return *this += 1; }
+    BigInt& operator--() { return *this -= 1; }
+
+    BigInt operator++(int) {
+        BigInt old = *this;
+        *this += 1;
+        return old;
+    }
+
+    BigInt operator--(int) {
+        BigInt old = *this;
+        *this -= 1;
+        return old;
+    }
+
+    friend BigInt operator+(BigInt a, const BigInt& b) { return a += b; }
+    friend BigInt operator-(BigInt a, const BigInt& b) { return a -= b; }
+    friend BigInt operator*(const BigInt& a, const BigInt& b) {
+        BigInt r = a;
+        return r *= b;
+    }
+    friend BigInt operator/(BigInt a, const BigInt& b) { return a /= b; }
+    friend BigInt operator%(BigInt a, const BigInt& b) { return a %= b; }
+
+    // ============ 比较 ============
+
+    friend int compare(const BigInt& a, const BigInt& b) {
+        if (a.negative_ != b.negative_) return a.negative_ ? -1 : 1;
+        int c = detail::compareMag(a.limbs_, b.limbs_);
+        return a.negative_ ? -c : c;
+    }
+
+    friend bool operator==(const BigInt& a, const BigInt& b) {
+        return a.negative_ == b.negative_ && a.limbs_ == b.limbs_;
+    }
+    friend bool operator!=(const BigInt& a, const BigInt& b) { return !(a == b); }
+    friend bool operator<(const BigInt& a, const BigInt& b) { return compare(a, b) < 0; }
+    friend bool operator<=(const BigInt& a, const BigInt& b) { return compare(a, b) <= 0; }
+    friend bool operator>(const BigInt& a, const BigInt& b) { return compare(a, b) > 0; }
+    friend bool operator>=(const BigInt& a, const BigInt& b) { return compare(a, b) >= 0; }
+
+    friend std::ostream& operator<<(std::ostream& os, const BigInt& value) { return os << value.toString(); }
+
+    // 同时得到商和余数，只做一次除法
+    friend void divMod(const BigInt& a, const BigInt& b, BigInt& quotient, BigInt& remainder) {
+        if (b.limbs_.empty()) {
+            quotient = BigInt();
+            remainder = a;
+            return;
+        }
+        detail::Limbs q, r;
+        detail::divModMag(a.limbs_, b.limbs_, q, r);
+        quotient.limbs_ = std::move(q);
+        quotient.negative_ = !quotient.limbs_.empty() && a.negative_ != b.negative_;
+        remainder.limbs_ = std::move(r);
+        remainder.negative_ = !remainder.limbs_.empty() && a.negative_;
+    }
+
+private:
+    // *this += (otherNegative ? -|other| : |other|)
+    BigInt& addSigned(const BigInt& other, bool otherNegative) {
+        if (negative_ == otherNegative) {
+            detail::addAt(limbs_, other.limbs_.data(), other.limbs_.size(), 0);
+            return *this;
+        }
+        if (detail::compareMag(limbs_, other.limbs_) >= 0) {
+            detail::subAt(limbs_, other.limbs_.data(), other.limbs_.size(), 0);
+        } else {
+            detail::Limbs mag = other.limbs_;
+            detail::subAt(mag, limbs_.data(), limbs_.size(), 0);
+            limbs_ = std::move(mag);
+            negative_ = otherNegative;
+        }
+        detail::trim(limbs_);
+        if (limbs_.empty()) negative_ = false;
+        return *this;
+    }
+
+    bool negative_ = false;
+    detail::Limbs limbs_;
+};
+
+inline std::string to_string(const BigInt& value) {
+    return value.toString();
+}
+
+inline BigInt bigInt(long long value) {
+    return BigInt(value);
+}
+
+inline std::optional<BigInt> parseBigInt(std::string_view s) {
+    return BigInt::parse(s);
+}
+
+// base^exp，exp < 0 时返回 0
+inline BigInt bigPow(BigInt base, long long exp) {
+    if (exp < 0) return BigInt();
+    BigInt result = 1;
+    while (exp > 0) {
+        if (exp & 1) result *= base;
+        exp >>= 1;
+        if (exp > 0) base *= base;
+    }
+    return result;
+}
+
+// ============ 阶乘与斐波那契 ============
+
+namespace detail {
+
+// lo·(lo+1)·…·hi：二分使两侧乘数规模相近，大乘法都落在 Karatsuba 上
+inline BigInt productRange(long long lo, long long hi) {
+    if (lo > hi) return 1;
+    if (hi - lo < 16) {
+        BigInt result = 1;
+        unsigned long long acc = 1;
+        for (long long i = lo; i <= hi; i++) {
+            unsigned long long f = static_cast<unsigned long long>(i);
+            if (acc > ULLONG_MAX / f) {
+                result *= acc;
+                acc = 1;
+            }
+            acc *= f;
+        }
+        return result *= acc;
+    }
+    long long mid = lo + (hi - lo) / 2;
+    return productRange(lo, mid) * productRange(mid + 1, hi);
+}
+
+} // namespace detail
+
+// n!，n < 0 时返回 0
+inline BigInt factorial(int n) {
+    if (n < 0) return BigInt();
+    return detail::productRange(2, n);
+}
+
+// 第 n 个斐波那契数（快速倍增），n <= 0 时返回 0：
+// F(2k) = F(k)·(2F(k+1) - F(k))，F(2k+1) = F(k)² + F(k+1)²
+inline BigInt fibonacci(int n) {
+    if (n <= 0) return BigInt();
+    BigInt a = 0;
+    BigInt b = 1;
+    for (int bit = 30; bit >= 0; bit--) {
+        BigInt c = a * (b + b - a);
+        BigInt d = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = std::move(d);
+            b = c + a;
+        } else {
+            a = std::move(c);
+            b = std::move(d);
+        }
+    }
+    return a;
+}
+
+} // namespace math
+} // namespace ljos
+
+#endif // LJOS_STD_BIGINT_HPP
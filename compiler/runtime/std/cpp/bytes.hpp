@@ -0,0 +1,329 @@
+/**
+ * Ljos Standard Library - Bytes (C++ Runtime)
+ * 不可变字节序列：引用计数共享底层内存，切片为 O(1)，可直接包装内存映射
+ */
+
+#ifndef LJOS_STD_BYTES_HPP
+#define LJOS_STD_BYTES_HPP
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ljos {
+
+// ============ Bytes ============
+
+// 只读字节视图 + 共享所有权。复制一个 Bytes 只增加引用计数，
+// slice 与原对象共享同一块内存，直到最后一个引用释放。
+class Bytes {
+public:
+    Bytes() = default;
+
+    // 复制一段内存
+    static Bytes copyFrom(const void* data, size_t size) {
+        return adopt(std::string(static_cast<const char*>(data), size));
+    }
+
+    static Bytes fromString(std::string_view s) {
+        return copyFrom(s.data(), s.size());
+    }
+
+    // 接管拥有者对象（std::string、std::vector<uint8_t>、fs::MappedFile 等
+    // 提供 data()/size() 的类型），不复制数据
+    template <typename Owner>
+    static Bytes adopt(Owner&& owner) {
+        using T = std::decay_t<Owner>;
+        auto holder = std::make_shared<T>(std::forward<Owner>(owner));
+        Bytes b;
+        b.data_ = reinterpret_cast<const uint8_t*>(holder->data());
+        b.size_ = static_cast<size_t>(holder->size());
+        b.owner_ = std::move(holder);
+        return b;
+    }
+
+    // 包装外部内存，由 owner 负责保持其存活（owner 为空时调用方自行保证）
+    static Bytes wrap(const void* data, size_t size, std::shared_ptr<const void> owner) {
+        Bytes b;
+        b.data_ = static_cast<const uint8_t*>(data);
+        b.size_ = size;
+        b.owner_ = std::move(owner);
+        return b;
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t length() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    uint8_t operator[](size_t i) const { return data_[i]; }
+
+    // 越界返回 -1
+    int at(size_t i) const { return i < size_ ? data_[i] : -1; }
+
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+
+    // 子序列 [start, end)，负数下标从末尾计算；与原对象共享内存
+    Bytes slice(long long start, long long end = LLONG_MAX) const {
+        long long len = static_cast<long long>(size_);
+        if (start < 0) start = std::max(0LL, len + start);
+        if (end < 0) end = len + end;
+        end = std::min(end, len);
+        if (start >= end) return Bytes();
+        Bytes b = *this;
+        b.data_ = data_ + start;
+        b.size_ = static_cast<size_t>(end - start);
+        return b;
+    }
+
+    // 等同 slice(start, start + count)，不处理负数
+    Bytes subarray(size_t start, size_t count) const {
+        start = std::min(start, size_);
+        count = std::min(count, size_ - start);
+        Bytes b = *this;
+        b.data_ = data_ + start;
+        b.size_ = count;
+        return b;
+    }
+
+    long long indexOf(uint8_t value, size_t start = 0) const {
+        if (start >= size_) return -1;
+        const void* p = std::memchr(data_ + start, value, size_ - start);
+        return p ? static_cast<const uint8_t*>(p) - data_ : -1;
+    }
+
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(data_), size_);
+    }
+
+    std::string toString() const { return std::string(view()); }
+
+    std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+
+    bool operator==(const Bytes& other) const { return view() == other.view(); }
+    bool operator!=(const Bytes& other) const { return !(*this == other); }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::shared_ptr<const void> owner_;
+};
+
+namespace detail {
+
+template <typename T>
+using UnsignedOf = std::make_unsigned_t<T>;
+
+// 移位拼装在 -O2 下会被合并为单条 load（必要时加 bswap），与主机字节序无关
+template <typename U>
+inline U loadLE(const uint8_t* p) {
+    U v = 0;
+    for (size_t i = 0; i < sizeof(U); ++i) v |= static_cast<U>(p[i]) << (8 * i);
+    return v;
+}
+
+template <typename U>
+inline U loadBE(const uint8_t* p) {
+    U v = 0;
+    for (size_t i = 0; i < sizeof(U); ++i) v = static_cast<U>(v << 8) | p[i];
+    return v;
+}
+
+template <typename U>
+inline void storeLE(uint8_t* p, U v) {
+    for (size_t i = 0; i < sizeof(U); ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+template <typename U>
+inline void storeBE(uint8_t* p, U v) {
+    for (size_t i = 0; i < sizeof(U); ++i) p[sizeof(U) - 1 - i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+template <typename To, typename From>
+inline To bitCast(From v) {
+    static_assert(sizeof(To) == sizeof(From), "size mismatch");
+    To out;
+    std::memcpy(&out, &v, sizeof(out));
+    return out;
+}
+
+} // namespace detail
+
+// ============ ByteReader - 读取游标 ============
+
+// 顺序解析二进制数据。越界读取返回 0 并置 ok() 为 false，
+// 之后的读取全部失败，解析结束时检查一次即可。
+class ByteReader {
+public:
+    explicit ByteReader(Bytes bytes) : bytes_(std::move(bytes)) {}
+
+    size_t position() const { return pos_; }
+    size_t remaining() const { return bytes_.size() - pos_; }
+    bool atEnd() const { return pos_ >= bytes_.size(); }
+    bool ok() const { return ok_; }
+
+    void seek(size_t pos) {
+        if (pos > bytes_.size()) {
+            ok_ = false;
+            pos = bytes_.size();
+        }
+        pos_ = pos;
+    }
+
+    void skip(size_t n) { seek(pos_ + std::min(n, remaining() + 1)); }
+
+    uint8_t u8() { return readLE<uint8_t>(); }
+    int8_t i8() { return readLE<int8_t>(); }
+
+    uint16_t u16le() { return readLE<uint16_t>(); }
+    uint32_t u32le() { return readLE<uint32_t>(); }
+    uint64_t u64le() { return readLE<uint64_t>(); }
+    int16_t i16le() { return readLE<int16_t>(); }
+    int32_t i32le() { return readLE<int32_t>(); }
+    int64_t i64le() { return readLE<int64_t>(); }
+
+    uint16_t u16be() { return readBE<uint16_t>(); }
+    uint32_t u32be() { return readBE<uint32_t>(); }
+    uint64_t u64be() { return readBE<uint64_t>(); }
+    int16_t i16be() { return readBE<int16_t>(); }
+    int32_t i32be() { return readBE<int32_t>(); }
+    int64_t i64be() { return readBE<int64_t>(); }
+
+    float f32le() { return detail::bitCast<float>(readLE<uint32_t>()); }
+    double f64le() { return detail::bitCast<double>(readLE<uint64_t>()); }
+    float f32be() { return detail::bitCast<float>(readBE<uint32_t>()); }
+    double f64be() { return detail::bitCast<double>(readBE<uint64_t>()); }
+
+    // 取出接下来的 n 个字节（零拷贝切片）
+    Bytes bytes(size_t n) {
+        if (!take(n)) return Bytes();
+        return bytes_.subarray(pos_ - n, n);
+    }
+
+    // 以字符串视图读取 n 个字节，生命周期同底层 Bytes
+    std::string_view view(size_t n) {
+        if (!take(n)) return std::string_view();
+        return bytes_.view().substr(pos_ - n, n);
+    }
+
+    // 剩余未读部分
+    Bytes rest() const { return bytes_.subarray(pos_, remaining()); }
+
+private:
+    bool take(size_t n) {
+        if (!ok_ || n > remaining()) {
+            ok_ = false;
+            return false;
+        }
+        pos_ += n;
+        return true;
+    }
+
+    template <typename T>
+    T readLE() {
+        if (!take(sizeof(T))) return 0;
+        return static_cast<T>(detail::loadLE<detail::UnsignedOf<T>>(bytes_.data() + pos_ - sizeof(T)));
+    }
+
+    template <typename T>
+    T readBE() {
+        if (!take(sizeof(T))) return 0;
+        return static_cast<T>(detail::loadBE<detail::UnsignedOf<T>>(bytes_.data() + pos_ - sizeof(T)));
+    }
+
+    Bytes bytes_;
+    size_t pos_ = 0;
+    bool ok_ = true;
+};
+
+// ============ ByteWriter - 写入游标 ============
+
+// 追加写入的字节缓冲区；finish() 直接接管内部缓冲区生成 Bytes，不再复制
+class ByteWriter {
+public:
+    explicit ByteWriter(size_t reserve = 0) { buffer_.reserve(reserve); }
+
+    size_t size() const { return buffer_.size(); }
+
+    void u8(uint8_t v) { buffer_.push_back(static_cast<char>(v)); }
+    void i8(int8_t v) { u8(static_cast<uint8_t>(v)); }
+
+    void u16le(uint16_t v) { writeLE(v); }
+    void u32le(uint32_t v) { writeLE(v); }
+    void u64le(uint64_t v) { writeLE(v); }
+    void i16le(int16_t v) { writeLE(static_cast<uint16_t>(v)); }
+    void i32le(int32_t v) { writeLE(static_cast<uint32_t>(v)); }
+    void i64le(int64_t v) { writeLE(static_cast<uint64_t>(v)); }
+
+    void u16be(uint16_t v) { writeBE(v); }
+    void u32be(uint32_t v) { writeBE(v); }
+    void u64be(uint64_t v) { writeBE(v); }
+    void i16be(int16_t v) { writeBE(static_cast<uint16_t>(v)); }
+    void i32be(int32_t v) { writeBE(static_cast<uint32_t>(v)); }
+    void i64be(int64_t v) { writeBE(static_cast<uint64_t>(v)); }
+
+    void f32le(float v) { writeLE(detail::bitCast<uint32_t>(v)); }
+    void f64le(double v) { writeLE(detail::bitCast<uint64_t>(v)); }
+    void f32be(float v) { writeBE(detail::bitCast<uint32_t>(v)); }
+    void f64be(double v) { writeBE(detail::bitCast<uint64_t>(v)); }
+
+    void bytes(const Bytes& b) { buffer_.append(b.view()); }
+    void bytes(std::string_view s) { buffer_.append(s); }
+
+    // 回填已写入位置的值（如长度前缀），越界时返回 false
+    bool setU32le(size_t pos, uint32_t v) { return patch(pos, v, false); }
+    bool setU32be(size_t pos, uint32_t v) { return patch(pos, v, true); }
+
+    // 生成 Bytes，之后写入器为空
+    Bytes finish() {
+        Bytes b = Bytes::adopt(std::move(buffer_));
+        buffer_ = std::string();
+        return b;
+    }
+
+private:
+    template <typename U>
+    void writeLE(U v) {
+        size_t at = grow(sizeof(U));
+        detail::storeLE(reinterpret_cast<uint8_t*>(&buffer_[at]), v);
+    }
+
+    template <typename U>
+    void writeBE(U v) {
+        size_t at = grow(sizeof(U));
+        detail::storeBE(reinterpret_cast<uint8_t*>(&buffer_[at]), v);
+    }
+
+    template <typename U>
+    bool patch(size_t pos, U v, bool bigEndian) {
+        if (pos > buffer_.size() || buffer_.size() - pos < sizeof(U)) return false;
+        auto* p = reinterpret_cast<uint8_t*>(&buffer_[pos]);
+        if (bigEndian) {
+            detail::storeBE(p, v);
+        } else {
+            detail::storeLE(p, v);
+        }
+        return true;
+    }
+
+    size_t grow(size_t n) {
+        size_t at = buffer_.size();
+        buffer_.resize(at + n);
+        return at;
+    }
+
+    std::string buffer_;
+};
+
+} // namespace ljos
+
+#endif // LJOS_STD_BYTES_HPP
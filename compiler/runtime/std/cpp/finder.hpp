@@ -0,0 +1,360 @@
+/**
+ * Ljos Standard Library - Substring Search (C++ Runtime)
+ * 预编译模式串的子串查找，供 indexOf / contains / split / replace 使用：
+ *   - 单字节：memchr
+ *   - 2..SHORT_NEEDLE_MAX 字节：首字节与末字节同时比较的 SIMD 过滤，候选位置再 memcmp；
+ *     x86 上有 SSE2 与 AVX2 两个版本，首次调用时按 CPU 选择
+ *   - 更长的模式串：Two-Way（Crochemore-Perrin）加窗口末字节跳转表，O(n + m) 时间，不会退化
+ * 环境变量 LJOS_SIMD=scalar|sse2 可以限制可用的最高指令集（用于对照测试）。
+ */
+
+#ifndef LJOS_STD_FINDER_HPP
+#define LJOS_STD_FINDER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LJOS_FINDER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ljos {
+namespace str {
+namespace search {
+
+constexpr size_t npos = std::string_view::npos;
+
+// 不超过这个长度的模式串走 SIMD 过滤；过滤器最坏 O(n·m)，m 有界时仍是线性的
+constexpr size_t SHORT_NEEDLE_MAX = 32;
+
+// ============ 标量实现 ============
+
+namespace scalar {
+
+// 调用方保证 2 <= m <= n
+inline size_t findShort(const char* h, size_t n, const char* x, size_t m) {
+    const char* end = h + (n - m + 1);
+    for (const char* p = h; p < end; p++) {
+        p = static_cast<const char*>(std::memchr(p, x[0], static_cast<size_t>(end - p)));
+        if (!p) return npos;
+        if (p[m - 1] == x[m - 1] && std::memcmp(p + 1, x + 1, m - 2) == 0) return static_cast<size_t>(p - h);
+    }
+    return npos;
+}
+
+} // namespace scalar
+
+// 向量块处理完后剩下不足一块的候选位置交给标量实现
+inline size_t findTail(const char* h, size_t n, const char* x, size_t m, size_t i) {
+    if (i + m > n) return npos;
+    size_t pos = scalar::findShort(h + i, n - i, x, m);
+    return pos == npos ? npos : i + pos;
+}
+
+#ifdef LJOS_FINDER_X86
+
+// ============ SSE2 ============
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace sse2 {
+
+inline size_t findShort(const char* h, size_t n, const char* x, size_t m) {
+    const __m128i first = _mm_set1_epi8(x[0]);
+    const __m128i last = _mm_set1_epi8(x[m - 1]);
+    size_t i = 0;
+    for (; i + 16 + m - 1 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + m - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        while (mask != 0) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(h + i + bit + 1, x + 1, m - 2) == 0) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    return findTail(h, n, x, m, i);
+}
+
+} // namespace sse2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+// ============ AVX2 ============
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+
+inline size_t findShort(const char* h, size_t n, const char* x, size_t m) {
+    const __m256i first = _mm256_set1_epi8(x[0]);
+    const __m256i last = _mm256_set1_epi8(x[m - 1]);
+    size_t i = 0;
+    for (; i + 32 + m - 1 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first), _mm256_cmpeq_epi8(b, last))));
+        while (mask != 0) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(h + i + bit + 1, x + 1, m - 2) == 0) return i + bit;
+            mask &= mask - 1;
+        }
+    }
+    return findTail(h, n, x, m, i);
+}
+
+} // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // LJOS_FINDER_X86
+
+// ============ 运行时分派 ============
+
+struct Kernels {
+    const char* isa;
+    size_t (*findShort)(const char*, size_t, const char*, size_t);
+};
+
+namespace detail {
+
+inline Kernels selectKernels() {
+    const char* cap = std::getenv("LJOS_SIMD");
+    bool scalarOnly = cap && std::strcmp(cap, "scalar") == 0;
+    bool noAvx2 = scalarOnly || (cap && std::strcmp(cap, "sse2") == 0);
+#ifdef LJOS_FINDER_X86
+    __builtin_cpu_init();
+    if (!noAvx2 && __builtin_cpu_supports("avx2")) return Kernels{"avx2", avx2::findShort};
+    if (!scalarOnly && __builtin_cpu_supports("sse2")) return Kernels{"sse2", sse2::findShort};
+#else
+    (void)noAvx2;
+#endif
+    return Kernels{"scalar", scalar::findShort};
+}
+
+} // namespace detail
+
+// 首次调用时检测一次
+inline const Kernels& kernels() {
+    static const Kernels table = detail::selectKernels();
+    return table;
+}
+
+// 当前使用的实现："scalar"、"sse2" 或 "avx2"
+inline const char* isa() { return kernels().isa; }
+
+// ============ Two-Way ============
+
+// 模式串的临界分解 x = x[0, suffix) · x[suffix, m)、周期，以及按窗口末字节跳转的位移表
+struct Factorization {
+    size_t suffix = 0;
+    size_t period = 1;
+    bool periodic = false;
+    uint32_t shift[256] = {};
+};
+
+// 按字节序（reversed 时反序）的最大后缀，返回其起点减 1（可能为 SIZE_MAX），period 为其周期
+inline size_t maxSuffix(const unsigned char* x, size_t m, bool reversed, size_t& period) {
+    size_t ms = SIZE_MAX;
+    size_t j = 0;
+    size_t k = 1;
+    size_t p = 1;
+    while (j + k < m) {
+        unsigned char a = x[j + k];
+        unsigned char b = x[ms + k];
+        if (reversed ? b < a : a < b) {
+            j += k;
+            k = 1;
+            p = j - ms;
+        } else if (a == b) {
+            if (k != p) {
+                k++;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            ms = j++;
+            k = p = 1;
+        }
+    }
+    period = p;
+    return ms;
+}
+
+inline Factorization factorize(std::string_view needle) {
+    auto x = reinterpret_cast<const unsigned char*>(needle.data());
+    size_t m = needle.size();
+    size_t p1 = 1;
+    size_t p2 = 1;
+    size_t ms1 = maxSuffix(x, m, false, p1);
+    size_t ms2 = maxSuffix(x, m, true, p2);
+
+    Factorization f;
+    // 两个最大后缀中起点靠后的那个给出临界位置
+    if (ms2 + 1 < ms1 + 1) {
+        f.suffix = ms1 + 1;
+        f.period = p1;
+    } else {
+        f.suffix = ms2 + 1;
+        f.period = p2;
+    }
+    f.periodic = std::memcmp(x, x + f.period, f.suffix) == 0;
+    if (!f.periodic) f.period = std::max(f.suffix, m - f.suffix) + 1;
+
+    // 窗口末字节 c 与模式串末字节对齐所需的最小位移（Horspool）
+    for (uint32_t& s : f.shift) s = static_cast<uint32_t>(m);
+    for (size_t i = 0; i < m; i++) f.shift[x[i]] = static_cast<uint32_t>(m - i - 1);
+    return f;
+}
+
+// 调用方保证 m <= n。先按窗口末字节跳转，末字节对上后再做 Two-Way 比较；
+// 位移只会跳过不可能匹配的位置，最坏情况仍是 O(n + m)
+inline size_t twoWay(const char* h, size_t n, const char* needle, size_t m, const Factorization& f) {
+    auto y = reinterpret_cast<const unsigned char*>(h);
+    auto x = reinterpret_cast<const unsigned char*>(needle);
+    size_t j = 0;
+
+    if (f.periodic) {
+        // 周期模式串：memory 记住上次已匹配的前缀长度，避免重复比较
+        size_t memory = 0;
+        while (j <= n - m) {
+            size_t shift = f.shift[y[j + m - 1]];
+            if (shift > 0) {
+                // 跳得不够一个周期时保留已知前缀会出错，直接对齐到下一个周期
+                if (memory != 0 && shift < f.period) shift = m - f.period;
+                memory = 0;
+                j += shift;
+                continue;
+            }
+            size_t i = std::max(f.suffix, memory);
+            while (i < m - 1 && x[i] == y[i + j]) i++;
+            if (i >= m - 1) {
+                i = f.suffix - 1;
+                while (memory < i + 1 && x[i] == y[i + j]) i--;
+                if (i + 1 < memory + 1) return j;
+                j += f.period;
+                memory = m - f.period;
+            } else {
+                j += i - f.suffix + 1;
+                memory = 0;
+            }
+        }
+    } else {
+        while (j <= n - m) {
+            size_t shift = f.shift[y[j + m - 1]];
+            if (shift > 0) {
+                j += shift;
+                continue;
+            }
+            size_t i = f.suffix;
+            while (i < m - 1 && x[i] == y[i + j]) i++;
+            if (i >= m - 1) {
+                i = f.suffix - 1;
+                while (i != SIZE_MAX && x[i] == y[i + j]) i--;
+                if (i == SIZE_MAX) return j;
+                j += f.period;
+            } else {
+                j += i - f.suffix + 1;
+            }
+        }
+    }
+    return npos;
+}
+
+} // namespace search
+
+// ============ Finder ============
+
+// 预编译的模式串：长模式串在构造时做一次 Two-Way 分解并建跳转表，之后可在任意多个字符串上重复查找。
+// 返回值与 std::string::find 相同（找不到为 npos，空模式串匹配 start）
+class Finder {
+public:
+    static constexpr size_t npos = search::npos;
+
+    explicit Finder(std::string needle) : needle_(std::move(needle)) {
+        if (needle_.size() > search::SHORT_NEEDLE_MAX) factors_ = search::factorize(needle_);
+    }
+
+    size_t find(std::string_view haystack, size_t start = 0) const {
+        return findIn(haystack, needle_, factors_, start);
+    }
+
+    bool containedIn(std::string_view haystack) const { return find(haystack) != npos; }
+
+    std::string_view needle() const { return needle_; }
+    size_t size() const { return needle_.size(); }
+
+    // 不保存模式串的一次性查找；长模式串每次都要重新分解
+    static size_t findOnce(std::string_view haystack, std::string_view needle, size_t start = 0) {
+        std::optional<search::Factorization> factors;
+        if (needle.size() > search::SHORT_NEEDLE_MAX && needle.size() <= haystack.size()) {
+            factors = search::factorize(needle);
+        }
+        return findIn(haystack, needle, factors, start);
+    }
+
+private:
+    // 短模式串不需要分解，factors 留空，省去每次清零 1KB 跳转表
+    static size_t findIn(std::string_view haystack, std::string_view needle,
+                         const std::optional<search::Factorization>& factors, size_t start) {
+        if (start > haystack.size()) return npos;
+        size_t m = needle.size();
+        size_t n = haystack.size() - start;
+        if (m == 0) return start;
+        if (m > n) return npos;
+
+        const char* h = haystack.data() + start;
+        size_t pos;
+        if (m == 1) {
+            auto p = static_cast<const char*>(std::memchr(h, needle[0], n));
+            pos = p ? static_cast<size_t>(p - h) : npos;
+        } else if (m <= search::SHORT_NEEDLE_MAX) {
+            pos = search::kernels().findShort(h, n, needle.data(), m);
+        } else {
+            pos = search::twoWay(h, n, needle.data(), m, *factors);
+        }
+        return pos == npos ? npos : start + pos;
+    }
+
+    std::string needle_;
+    std::optional<search::Factorization> factors_;
+};
+
+// 一次性查找，语义同 std::string_view::find
+inline size_t find(std::string_view haystack, std::string_view needle, size_t start = 0) {
+    return Finder::findOnce(haystack, needle, start);
+}
+
+} // namespace str
+} // namespace ljos
+
+#endif // LJOS_STD_FINDER_HPP
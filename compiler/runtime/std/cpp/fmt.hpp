@@ -0,0 +1,647 @@
+/**
+ * Ljos Standard Library - Number Formatting (C++ Runtime)
+ * 数字格式化核心：整数按两位查表输出，浮点数输出能精确往返的最短表示，
+ * 另有定点与指数两种定精度模式。所有函数都写入调用方提供的缓冲区，不分配内存。
+ * 格式串（%s %d ...）可在编译期解析，生成不再解析格式的专用写入代码。
+ */
+
+#ifndef LJOS_STD_FMT_HPP
+#define LJOS_STD_FMT_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// 标准库提供最短往返的浮点 to_chars 时直接使用，否则用 snprintf 逐级提高精度回退
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define LJOS_FMT_FLOAT_TO_CHARS 1
+#endif
+
+namespace ljos {
+namespace fmt {
+
+// ============ 缓冲区大小 ============
+
+// 任意 64 位整数（含符号）
+constexpr size_t INT_BUFFER_SIZE = 24;
+
+// 最短往返格式的浮点数（含符号、小数点与指数）
+constexpr size_t FLOAT_BUFFER_SIZE = 32;
+
+namespace detail {
+
+// "00" "01" ... "99"：每次除以 100 输出两位，除法次数减半
+struct DigitPairs {
+    char data[200];
+    constexpr DigitPairs() : data() {
+        for (int i = 0; i < 100; ++i) {
+            data[2 * i] = static_cast<char>('0' + i / 10);
+            data[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+    }
+};
+
+inline constexpr DigitPairs DIGIT_PAIRS{};
+
+inline int countDigits(uint64_t v) {
+    int n = 1;
+    for (;;) {
+        if (v < 10) return n;
+        if (v < 100) return n + 1;
+        if (v < 1000) return n + 2;
+        if (v < 10000) return n + 3;
+        v /= 10000;
+        n += 4;
+    }
+}
+
+// 先算出位数，再从末尾向前两位一组填充
+inline char* writeUnsigned(char* out, uint64_t v) {
+    int n = countDigits(v);
+    char* p = out + n;
+    while (v >= 100) {
+        size_t idx = static_cast<size_t>(v % 100) * 2;
+        v /= 100;
+        p -= 2;
+        std::memcpy(p, DIGIT_PAIRS.data + idx, 2);
+    }
+    if (v >= 10) {
+        p -= 2;
+        std::memcpy(p, DIGIT_PAIRS.data + v * 2, 2);
+    } else {
+        *--p = static_cast<char>('0' + v);
+    }
+    return out + n;
+}
+
+inline char* writeString(char* out, std::string_view s) {
+    std::memcpy(out, s.data(), s.size());
+    return out + s.size();
+}
+
+// NaN 与无穷大按 JavaScript 的写法输出，两个后端结果一致
+inline char* writeNonFinite(char* out, double v) {
+    if (std::isnan(v)) return writeString(out, "NaN");
+    return writeString(out, v < 0 ? "-Infinity" : "Infinity");
+}
+
+// 十进制有效数字：value = 0.d1d2...dk × 10^point
+struct Decimal {
+    char digits[24];
+    int length = 0;
+    int point = 0;
+};
+
+// 解析 "d.ddde±XX" 形式的科学计数法文本，去掉末尾多余的 0
+inline void parseScientific(const char* first, const char* last, Decimal& dec) {
+    dec.length = 0;
+    const char* p = first;
+    for (; p < last && *p != 'e' && *p != 'E'; ++p) {
+        if (*p >= '0' && *p <= '9') dec.digits[dec.length++] = *p;
+    }
+    int exp = 0;
+    bool neg = false;
+    if (p < last) ++p;
+    if (p < last && (*p == '+' || *p == '-')) neg = (*p++ == '-');
+    for (; p < last; ++p) exp = exp * 10 + (*p - '0');
+    while (dec.length > 1 && dec.digits[dec.length - 1] == '0') --dec.length;
+    dec.point = (neg ? -exp : exp) + 1;
+}
+
+// 能精确还原 v 的最短十进制数字（v 为正的有限非零值）
+template <typename T>
+inline void shortestDecimal(T v, Decimal& dec) {
+    char buf[48];
+#ifdef LJOS_FMT_FLOAT_TO_CHARS
+    auto res = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::scientific);
+    parseScientific(buf, res.ptr, dec);
+#else
+    constexpr int maxPrecision = std::is_same_v<T, float> ? 9 : 17;
+    int n = 0;
+    for (int precision = 0; precision < maxPrecision; ++precision) {
+        n = std::snprintf(buf, sizeof(buf), "%.*e", precision, static_cast<double>(v));
+        T back;
+        if constexpr (std::is_same_v<T, float>) {
+            back = std::strtof(buf, nullptr);
+        } else {
+            back = std::strtod(buf, nullptr);
+        }
+        if (back == v) break;
+    }
+    parseScientific(buf, buf + n, dec);
+#endif
+}
+
+inline char* writeExponent(char* out, int exp) {
+    *out++ = 'e';
+    *out++ = exp < 0 ? '-' : '+';
+    return writeUnsigned(out, static_cast<uint64_t>(exp < 0 ? -exp : exp));
+}
+
+// 按 JavaScript Number#toString 的规则排布数字：
+// 1e-7 <= |v| < 1e21 用普通小数，其余用指数形式
+inline char* layoutShortest(char* out, const Decimal& dec) {
+    int k = dec.length;
+    int n = dec.point;
+    if (k <= n && n <= 21) {
+        out = writeString(out, std::string_view(dec.digits, k));
+        std::memset(out, '0', static_cast<size_t>(n - k));
+        return out + (n - k);
+    }
+    if (0 < n && n <= 21) {
+        out = writeString(out, std::string_view(dec.digits, n));
+        *out++ = '.';
+        return writeString(out, std::string_view(dec.digits + n, k - n));
+    }
+    if (-6 < n && n <= 0) {
+        *out++ = '0';
+        *out++ = '.';
+        std::memset(out, '0', static_cast<size_t>(-n));
+        out += -n;
+        return writeString(out, std::string_view(dec.digits, k));
+    }
+    *out++ = dec.digits[0];
+    if (k > 1) {
+        *out++ = '.';
+        out = writeString(out, std::string_view(dec.digits + 1, k - 1));
+    }
+    return writeExponent(out, n - 1);
+}
+
+template <typename T>
+inline char* formatShortest(char* out, T v) {
+    if (!std::isfinite(v)) return writeNonFinite(out, v);
+    if (v == 0) {
+        *out++ = '0';
+        return out;
+    }
+    if (v < 0) {
+        *out++ = '-';
+        v = -v;
+    }
+    Decimal dec;
+    shortestDecimal(v, dec);
+    return layoutShortest(out, dec);
+}
+
+// 定精度输出的 snprintf 回退；放不下时返回 nullptr
+inline char* printfInto(char* first, char* last, const char* spec, int precision, double v) {
+    size_t cap = static_cast<size_t>(last - first);
+    int n = std::snprintf(first, cap, spec, precision, v);
+    if (n < 0 || static_cast<size_t>(n) >= cap) return nullptr;
+    return first + n;
+}
+
+} // namespace detail
+
+// ============ 整数 ============
+
+// 写入十进制整数，返回写入结束位置；缓冲区至少 INT_BUFFER_SIZE 字节
+template <typename T>
+inline char* formatInt(char* out, T value) {
+    static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "formatInt requires an integer");
+    using U = std::make_unsigned_t<T>;
+    U u = static_cast<U>(value);
+    if constexpr (std::is_signed_v<T>) {
+        if (value < 0) {
+            *out++ = '-';
+            u = static_cast<U>(U(0) - u);
+        }
+    }
+    return detail::writeUnsigned(out, static_cast<uint64_t>(u));
+}
+
+// ============ 浮点数 ============
+
+// 最短往返表示（与 JavaScript 的 String(number) 相同）：
+// 2.5 → "2.5"，0.1 + 0.2 → "0.30000000000000004"，1e21 → "1e+21"
+// 缓冲区至少 FLOAT_BUFFER_SIZE 字节
+inline char* formatDouble(char* out, double value) {
+    return detail::formatShortest(out, value);
+}
+
+inline char* formatDouble(char* out, float value) {
+    return detail::formatShortest(out, value);
+}
+
+// 定点模式：小数点后固定 precision 位（同 toFixed），放不下时返回 nullptr
+inline char* formatFixed(char* first, char* last, double value, int precision) {
+    if (precision < 0) precision = 0;
+    if (!std::isfinite(value)) {
+        if (last - first < 9) return nullptr;
+        return detail::writeNonFinite(first, value);
+    }
+#ifdef LJOS_FMT_FLOAT_TO_CHARS
+    auto res = std::to_chars(first, last, value, std::chars_format::fixed, precision);
+    return res.ec == std::errc() ? res.ptr : nullptr;
+#else
+    return detail::printfInto(first, last, "%.*f", precision, value);
+#endif
+}
+
+// 指数模式：尾数保留 precision 位小数（同 toExponential），precision < 0 时取最短往返位数；
+// 指数不补零，如 "1.5e+3"。放不下时返回 nullptr
+inline char* formatExponent(char* first, char* last, double value, int precision = -1) {
+    if (!std::isfinite(value)) {
+        if (last - first < 9) return nullptr;
+        return detail::writeNonFinite(first, value);
+    }
+    char buf[FLOAT_BUFFER_SIZE];
+    char* out = first;
+    if (precision < 0) {
+        detail::Decimal dec;
+        if (value == 0) {
+            dec.digits[0] = '0';
+            dec.length = 1;
+            dec.point = 1;
+        } else {
+            detail::shortestDecimal(std::fabs(value), dec);
+        }
+        char* p = buf;
+        if (std::signbit(value) && value != 0) *p++ = '-';
+        *p++ = dec.digits[0];
+        if (dec.length > 1) {
+            *p++ = '.';
+            p = detail::writeString(p, std::string_view(dec.digits + 1, dec.length - 1));
+        }
+        p = detail::writeExponent(p, dec.point - 1);
+        size_t n = static_cast<size_t>(p - buf);
+        if (static_cast<size_t>(last - first) < n) return nullptr;
+        return detail::writeString(out, std::string_view(buf, n));
+    }
+#ifdef LJOS_FMT_FLOAT_TO_CHARS
+    auto res = std::to_chars(first, last, value, std::chars_format::scientific, precision);
+    if (res.ec != std::errc()) return nullptr;
+    char* end = res.ptr;
+#else
+    char* end = detail::printfInto(first, last, "%.*e", precision, value);
+    if (!end) return nullptr;
+#endif
+    // 把 "e+05" 收缩为 "e+5"，结果只会变短
+    char* e = static_cast<char*>(std::memchr(first, 'e', static_cast<size_t>(end - first)));
+    if (!e || end - e < 3) return end;
+    char* digits = e + 2;
+    char* nonZero = digits;
+    while (nonZero < end - 1 && *nonZero == '0') ++nonZero;
+    std::memmove(digits, nonZero, static_cast<size_t>(end - nonZero));
+    return end - (nonZero - digits);
+}
+
+// ============ 追加到字符串 ============
+
+// 把任意可打印值追加到 out：数字直接格式化进 out 的尾部，不经过临时字符串
+template <typename T>
+inline void appendTo(std::string& out, const T& value) {
+    using V = std::decay_t<T>;
+    if constexpr (std::is_same_v<V, bool>) {
+        out.append(value ? "true" : "false");
+    } else if constexpr (std::is_same_v<V, char>) {
+        out.push_back(value);
+    } else if constexpr (std::is_integral_v<V>) {
+        size_t at = out.size();
+        out.resize(at + INT_BUFFER_SIZE);
+        char* end = formatInt(&out[at], value);
+        out.resize(static_cast<size_t>(end - out.data()));
+    } else if constexpr (std::is_floating_point_v<V>) {
+        size_t at = out.size();
+        out.resize(at + FLOAT_BUFFER_SIZE);
+        char* end = formatDouble(&out[at], value);
+        out.resize(static_cast<size_t>(end - out.data()));
+    } else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+        out.append(std::string_view(value));
+    } else {
+        using std::to_string;
+        out.append(to_string(value));
+    }
+}
+
+namespace detail {
+
+template <typename T>
+inline size_t sizeHint(const T& value) {
+    using V = std::decay_t<T>;
+    if constexpr (std::is_arithmetic_v<V>) {
+        return FLOAT_BUFFER_SIZE;
+    } else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+        return std::string_view(value).size();
+    } else {
+        return 16;
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+inline std::string toString(const T& value) {
+    std::string out;
+    appendTo(out, value);
+    return out;
+}
+
+// 拼接任意个值（模板字符串的原生实现），先按估算长度一次性预留空间
+template <typename... Args>
+inline std::string concat(const Args&... args) {
+    std::string out;
+    out.reserve((size_t(0) + ... + detail::sizeHint(args)));
+    (appendTo(out, args), ...);
+    return out;
+}
+
+inline std::string toFixed(double value, int precision) {
+    if (precision < 0) precision = 0;
+    // 定点输出最长为 309 位整数部分 + 小数点 + precision 位小数
+    std::string out(static_cast<size_t>(precision) + 320, '\0');
+    char* end = formatFixed(&out[0], &out[0] + out.size(), value, precision);
+    out.resize(end ? static_cast<size_t>(end - out.data()) : 0);
+    return out;
+}
+
+inline std::string toExponential(double value, int precision = -1) {
+    std::string out(static_cast<size_t>(precision < 0 ? 0 : precision) + FLOAT_BUFFER_SIZE, '\0');
+    char* end = formatExponent(&out[0], &out[0] + out.size(), value, precision);
+    out.resize(end ? static_cast<size_t>(end - out.data()) : 0);
+    return out;
+}
+
+// ============ 格式串 ============
+// 与 JS 运行时相同的占位符：%s 字符串  %d/%i 整数  %f 浮点数  %o JSON  %b 布尔  %% 百分号
+// 其他 % 序列原样输出。
+
+enum class Spec : char { Literal, Str, Int, Float, Json, Bool };
+
+// Literal 段对应格式串中的 [pos, pos + length)，占位符段的 pos 为参数下标
+struct Segment {
+    Spec spec;
+    size_t pos;
+    size_t length;
+};
+
+namespace detail {
+
+constexpr Spec specOf(char c) {
+    switch (c) {
+        case 's': return Spec::Str;
+        case 'd':
+        case 'i': return Spec::Int;
+        case 'f': return Spec::Float;
+        case 'o': return Spec::Json;
+        case 'b': return Spec::Bool;
+        default: return Spec::Literal;
+    }
+}
+
+// 逐段切分格式串；segments 为空时只计数。返回段数
+constexpr size_t splitFormat(std::string_view f, Segment* segments, size_t* argCount) {
+    size_t count = 0;
+    size_t args = 0;
+    size_t start = 0;
+    auto emit = [&](Spec spec, size_t pos, size_t length) {
+        if (segments) segments[count] = Segment{spec, pos, length};
+        ++count;
+    };
+    for (size_t i = 0; i + 1 < f.size(); ++i) {
+        if (f[i] != '%') continue;
+        char c = f[i + 1];
+        Spec spec = specOf(c);
+        if (c != '%' && spec == Spec::Literal) continue;
+        if (i > start) emit(Spec::Literal, start, i - start);
+        if (c == '%') {
+            emit(Spec::Literal, i + 1, 1);
+        } else {
+            emit(spec, args++, 0);
+        }
+        start = i + 2;
+        ++i;
+    }
+    if (start < f.size()) emit(Spec::Literal, start, f.size() - start);
+    if (argCount) *argCount = args;
+    return count;
+}
+
+constexpr size_t segmentCount(std::string_view f) {
+    return splitFormat(f, nullptr, nullptr);
+}
+
+constexpr size_t placeholderCount(std::string_view f) {
+    size_t args = 0;
+    splitFormat(f, nullptr, &args);
+    return args;
+}
+
+template <size_t N>
+constexpr std::array<Segment, N> parseFormat(std::string_view f) {
+    std::array<Segment, N> segments{};
+    splitFormat(f, segments.data(), nullptr);
+    return segments;
+}
+
+template <typename T>
+constexpr bool isNumber = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+template <typename T>
+constexpr bool isText = std::is_convertible_v<const T&, std::string_view>;
+
+inline void appendJsonString(std::string& out, std::string_view s) {
+    out.push_back('"');
+    for (char c : s) {
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    out.append(buf);
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+// %d：浮点数向零取整（同 parseInt），非有限值输出 NaN
+template <typename V>
+inline void appendInteger(std::string& out, const V& value) {
+    if constexpr (std::is_integral_v<V>) {
+        appendTo(out, value);
+    } else {
+        double v = std::trunc(static_cast<double>(value));
+        if (!std::isfinite(v)) {
+            out.append("NaN");
+        } else if (std::fabs(v) < 9.2e18) {
+            appendTo(out, static_cast<long long>(v));
+        } else {
+            appendTo(out, v);
+        }
+    }
+}
+
+template <typename V>
+inline bool truthy(const V& value) {
+    if constexpr (std::is_same_v<V, bool>) {
+        return value;
+    } else if constexpr (std::is_arithmetic_v<V>) {
+        return value == value && value != 0;
+    } else if constexpr (isText<V>) {
+        return !std::string_view(value).empty();
+    } else {
+        return true;
+    }
+}
+
+// 编译期已知占位符类型：类型不匹配时报编译错误
+template <Spec S, typename T>
+inline void appendSpec(std::string& out, const T& value) {
+    using V = std::decay_t<T>;
+    if constexpr (S == Spec::Str) {
+        appendTo(out, value);
+    } else if constexpr (S == Spec::Int) {
+        static_assert(isNumber<V>, "format: %d / %i expects a number argument");
+        appendInteger(out, value);
+    } else if constexpr (S == Spec::Float) {
+        static_assert(isNumber<V>, "format: %f expects a number argument");
+        appendTo(out, static_cast<double>(value));
+    } else if constexpr (S == Spec::Bool) {
+        static_assert(std::is_arithmetic_v<V> || isText<V>, "format: %b expects a bool, number or string argument");
+        appendTo(out, truthy(value));
+    } else if constexpr (S == Spec::Json) {
+        if constexpr (isText<V>) {
+            appendJsonString(out, std::string_view(value));
+        } else if constexpr (std::is_floating_point_v<V>) {
+            if (std::isfinite(value)) {
+                appendTo(out, value);
+            } else {
+                out.append("null");
+            }
+        } else {
+            appendTo(out, value);
+        }
+    }
+}
+
+// 运行期格式串：类型不匹配时按 %s 输出，不报错
+template <typename T>
+inline void appendDynamic(std::string& out, Spec spec, const T& value) {
+    using V = std::decay_t<T>;
+    switch (spec) {
+        case Spec::Int:
+            if constexpr (isNumber<V>) {
+                appendSpec<Spec::Int>(out, value);
+                return;
+            }
+            break;
+        case Spec::Float:
+            if constexpr (isNumber<V>) {
+                appendSpec<Spec::Float>(out, value);
+                return;
+            }
+            break;
+        case Spec::Bool:
+            appendTo(out, truthy(value));
+            return;
+        case Spec::Json:
+            appendSpec<Spec::Json>(out, value);
+            return;
+        default:
+            break;
+    }
+    appendTo(out, value);
+}
+
+// 格式串在编译期切分后的结果
+template <typename Format>
+struct Parsed {
+    static constexpr std::string_view text = Format::text();
+    static constexpr size_t size = segmentCount(text);
+    static constexpr size_t args = placeholderCount(text);
+    static constexpr std::array<Segment, size> segments = parseFormat<size>(text);
+};
+
+// 每一段展开为一条 append，运行时不再解析格式
+template <typename P, typename Tuple, size_t... I>
+inline void writeSegments(std::string& out, const Tuple& args, std::index_sequence<I...>) {
+    [[maybe_unused]] auto write = [&](auto index) {
+        constexpr Segment seg = P::segments[decltype(index)::value];
+        if constexpr (seg.spec == Spec::Literal) {
+            out.append(P::text.data() + seg.pos, seg.length);
+        } else if constexpr (seg.pos < std::tuple_size_v<Tuple>) {
+            appendSpec<seg.spec>(out, std::get<seg.pos>(args));
+        }
+    };
+    (write(std::integral_constant<size_t, I>()), ...);
+}
+
+template <typename T, typename = void>
+struct IsFormat : std::false_type {};
+
+template <typename T>
+struct IsFormat<T, std::void_t<decltype(T::text())>>
+    : std::bool_constant<std::is_same_v<decltype(T::text()), std::string_view>> {};
+
+} // namespace detail
+
+// 编译期格式串：LJOS_FORMAT("x = %d") 生成一个携带格式文本的类型，
+// 格式在编译期切分，占位符个数与参数类型在编译期检查
+#define LJOS_FORMAT(literal) \
+    ([] { \
+        struct LjosFormat { \
+            static constexpr std::string_view text() { return literal; } \
+        }; \
+        return LjosFormat{}; \
+    }())
+
+template <typename T>
+constexpr bool isFormat = detail::IsFormat<std::decay_t<T>>::value;
+
+template <typename Format, typename... Args>
+inline void formatTo(std::string& out, Format, const Args&... args) {
+    using P = detail::Parsed<Format>;
+    static_assert(P::args == sizeof...(Args),
+                  "format: argument count does not match the placeholders in the format string");
+    detail::writeSegments<P>(out, std::forward_as_tuple(args...), std::make_index_sequence<P::size>());
+}
+
+// 运行期格式串：单次扫描，直接追加到 out；缺少的参数保留占位符原样输出（同 JS）
+template <typename... Args>
+inline void formatDynamicTo(std::string& out, std::string_view f, const Args&... args) {
+    size_t start = 0;
+    size_t next = 0;
+    for (size_t i = 0; i + 1 < f.size(); ++i) {
+        if (f[i] != '%') continue;
+        char c = f[i + 1];
+        Spec spec = detail::specOf(c);
+        if (c != '%' && spec == Spec::Literal) continue;
+        out.append(f.data() + start, i - start);
+        start = i + 2;
+        if (c == '%') {
+            out.push_back('%');
+        } else if (next < sizeof...(Args)) {
+            size_t index = 0;
+            ((index++ == next ? detail::appendDynamic(out, spec, args) : void()), ...);
+            ++next;
+        } else {
+            out.append(f.data() + i, 2);
+        }
+        ++i;
+    }
+    out.append(f.data() + start, f.size() - start);
+}
+
+} // namespace fmt
+} // namespace ljos
+
+#endif // LJOS_STD_FMT_HPP
@@ -12,6 +12,49 @@
 #include <vector>
 #include <filesystem>
 #include <optional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <iterator>
+#include <cstdint>
+#include <future>
+#include <functional>
+#include <condition_variable>
+#include <unordered_map>
+#include <map>
+
+#include "aio.hpp"
+#include "bytes.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
+#define LJOS_FS_POSIX 1
+#endif
+
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#endif
 
 namespace ljos {
 namespace fs {
@@ -21,14 +64,188 @@ namespace stdfs = std::filesystem;
 // ============ 文件读写 ============
 
 // 读取整个文件内容
+// 按文件大小预分配后一次读入，避免 stringstream 的二次拷贝
 inline std::optional<std::string> readFile(const std::string& path) {
-    std::ifstream file(path);
+    std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) {
         return std::nullopt;
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    std::error_code ec;
+    auto size = stdfs::file_size(path, ec);
+    if (ec || size == 0) {
+        // 管道、/proc 等无法预知大小的文件退回流式读取
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+    std::string content(static_cast<size_t>(size), '\0');
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    content.resize(static_cast<size_t>(file.gcount()));
+    return content;
+}
+
+// ============ 内存映射读取 ============
+
+// 映射访问模式提示（对应 madvise）
+enum class MapAdvice {
+    Sequential,  // 顺序扫描：MADV_SEQUENTIAL | MADV_WILLNEED
+    Random,      // 随机访问：MADV_RANDOM
+    Normal       // 不给提示
+};
+
+// 只读文件映射，持有期间 view() 返回的内容一直有效
+// 接口与 std::optional<std::string> 相近，可直接替换 readFile 的只读结果
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile() { reset(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { moveFrom(other); }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool isOpen() const { return open_; }
+
+    std::string_view view() const { return std::string_view(data_, size_); }
+    std::string toString() const { return std::string(data_, size_); }
+
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+
+    // optional 风格访问
+    bool has_value() const { return open_; }
+    explicit operator bool() const { return open_; }
+    std::string_view operator*() const { return view(); }
+    std::string_view value() const { return view(); }
+    operator std::string_view() const { return view(); }
+
+    // 与 std::string / 字符串字面量按内容比较
+    // 未打开的 MappedFile 与 std::nullopt 的比较结果一致：不等于任何字符串，且小于任何字符串
+    friend bool operator==(const MappedFile& a, std::string_view b) { return a.open_ && a.view() == b; }
+    friend bool operator!=(const MappedFile& a, std::string_view b) { return !a.open_ || a.view() != b; }
+    friend bool operator<(const MappedFile& a, std::string_view b) { return !a.open_ || a.view() < b; }
+    friend bool operator<=(const MappedFile& a, std::string_view b) { return !a.open_ || a.view() <= b; }
+    friend bool operator>(const MappedFile& a, std::string_view b) { return a.open_ && a.view() > b; }
+    friend bool operator>=(const MappedFile& a, std::string_view b) { return a.open_ && a.view() >= b; }
+    friend bool operator==(std::string_view a, const MappedFile& b) { return b == a; }
+    friend bool operator!=(std::string_view a, const MappedFile& b) { return b != a; }
+    friend bool operator<(std::string_view a, const MappedFile& b) { return b > a; }
+    friend bool operator<=(std::string_view a, const MappedFile& b) { return b >= a; }
+    friend bool operator>(std::string_view a, const MappedFile& b) { return b < a; }
+    friend bool operator>=(std::string_view a, const MappedFile& b) { return b <= a; }
+
+private:
+    friend MappedFile mapFile(const std::string& path, MapAdvice advice);
+
+    void reset() {
+#ifdef LJOS_FS_POSIX
+        if (mapped_ && data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+        mapped_ = false;
+        fallback_.clear();
+    }
+
+    void moveFrom(MappedFile& other) {
+        open_ = other.open_;
+        mapped_ = other.mapped_;
+        size_ = other.size_;
+        if (mapped_) {
+            data_ = other.data_;
+        } else {
+            fallback_ = std::move(other.fallback_);
+            data_ = fallback_.data();
+        }
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.open_ = false;
+        other.mapped_ = false;
+    }
+
+    void adoptBuffer(std::string content) {
+        fallback_ = std::move(content);
+        data_ = fallback_.data();
+        size_ = fallback_.size();
+        open_ = true;
+        mapped_ = false;
+    }
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+    bool mapped_ = false;
+    std::string fallback_;  // 无法映射时（管道、非 POSIX 平台）的读入缓冲
+};
+
+// 以只读方式映射整个文件；失败时返回未打开的 MappedFile
+inline MappedFile mapFile(const std::string& path, MapAdvice advice = MapAdvice::Sequential) {
+    MappedFile mf;
+#ifdef LJOS_FS_POSIX
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return mf;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return mf;
+    }
+    if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+        ::close(fd);
+        // 空文件无法映射；特殊文件（管道、/proc）的 st_size 不可信，走普通读取
+        if (auto content = readFile(path)) {
+            mf.adoptBuffer(std::move(*content));
+        }
+        return mf;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // 映射建立后即可关闭描述符
+    if (addr == MAP_FAILED) {
+        if (auto content = readFile(path)) {
+            mf.adoptBuffer(std::move(*content));
+        }
+        return mf;
+    }
+    switch (advice) {
+        case MapAdvice::Sequential:
+            ::madvise(addr, size, MADV_SEQUENTIAL);
+            ::madvise(addr, size, MADV_WILLNEED);
+            break;
+        case MapAdvice::Random:
+            ::madvise(addr, size, MADV_RANDOM);
+            break;
+        case MapAdvice::Normal:
+            break;
+    }
+    mf.data_ = static_cast<const char*>(addr);
+    mf.size_ = size;
+    mf.open_ = true;
+    mf.mapped_ = true;
+#else
+    (void)advice;
+    if (auto content = readFile(path)) {
+        mf.adoptBuffer(std::move(*content));
+    }
+#endif
+    return mf;
 }
 
 // 写入文件（覆盖）
@@ -51,41 +268,1072 @@ inline bool appendFile(const std::string& path, const std::string& content) {
     return true;
 }
 
-// 按行读取文件
-inline std::vector<std::string> readLines(const std::string& path) {
-    std::vector<std::string> lines;
-    std::ifstream file(path);
+// 读取文件为字节序列：读入自有的缓冲区，之后文件被改写或截断都不影响结果
+inline std::optional<Bytes> readFileBytes(const std::string& path) {
+    auto content = readFile(path);
+    if (!content) {
+        return std::nullopt;
+    }
+    return Bytes::adopt(std::move(*content));
+}
+
+// 以内存映射包装文件，不复制数据。映射不是快照：持有期间文件被改写会改变内容，
+// 被截断时访问会触发 SIGBUS，所以只用于持有期间不会被写入的文件（包括不能把结果写回同一路径）
+inline std::optional<Bytes> mapFileBytes(const std::string& path) {
+    MappedFile mf = mapFile(path);
+    if (!mf) {
+        return std::nullopt;
+    }
+    return Bytes::adopt(std::move(mf));
+}
+
+// 写入字节序列（覆盖）
+inline bool writeFileBytes(const std::string& path, const Bytes& content) {
+    std::ofstream file(path, std::ios::binary);
     if (!file.is_open()) {
-        return lines;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+    return file.good();
+}
+
+// 直接写出 readFileBytes 的结果（Ljos 的 Result<Bytes, Error>）；读取失败时返回 false，不创建文件
+inline bool writeFileBytes(const std::string& path, const std::optional<Bytes>& content) {
+    return content && writeFileBytes(path, *content);
+}
+
+// ============ 异步读写 ============
+// 原生后端由 ljos::aio 引擎完成（io_uring 或线程池），await 即取 future 的结果。
+// 大文件拆成多个块一次批量提交，单个线程即可让多个读写同时在途。
+
+namespace detail {
+
+constexpr size_t ASYNC_CHUNK_SIZE = 1 << 20;
+
+#if defined(LJOS_AIO_POSIX)
+
+// 一次异步读/写整个文件的共享状态，最后一个完成的块负责收尾
+struct AsyncFileOp {
+    int fd = -1;
+    std::string data;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> end{0};     // 读：遇到 EOF 时截断到的位置
+    std::atomic<bool> failed{false};
+    bool writing = false;
+    std::promise<std::optional<std::string>> readResult;
+    std::promise<bool> writeResult;
+};
+
+inline void finishAsyncOp(AsyncFileOp& op) {
+    ::close(op.fd);
+    bool ok = !op.failed.load(std::memory_order_acquire);
+    if (op.writing) {
+        op.writeResult.set_value(ok);
+    } else if (ok) {
+        op.data.resize(op.end.load(std::memory_order_acquire));
+        op.readResult.set_value(std::move(op.data));
+    } else {
+        op.readResult.set_value(std::nullopt);
+    }
+}
+
+inline aio::Request asyncChunk(const std::shared_ptr<AsyncFileOp>& op, size_t offset, size_t len) {
+    aio::Request req;
+    req.op = op->writing ? aio::OpCode::Write : aio::OpCode::Read;
+    req.fd = op->fd;
+    req.buf = &op->data[offset];
+    req.len = len;
+    req.offset = offset;
+    req.done = [op, offset, len](long result) {
+        if (result > 0 && static_cast<size_t>(result) < len) {
+            // 短读/短写：继续处理剩余部分
+            size_t done = static_cast<size_t>(result);
+            aio::Engine::instance().submit(asyncChunk(op, offset + done, len - done));
+            return;
+        }
+        if (result < 0 || (result == 0 && op->writing)) {
+            op->failed.store(true, std::memory_order_release);
+        } else if (result == 0) {
+            // 文件在读取期间变短
+            size_t cur = op->end.load(std::memory_order_relaxed);
+            while (offset < cur && !op->end.compare_exchange_weak(cur, offset)) {
+            }
+        }
+        if (op->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finishAsyncOp(*op);
+        }
+    };
+    return req;
+}
+
+// 按块批量提交整个缓冲区
+inline void submitAsyncChunks(const std::shared_ptr<AsyncFileOp>& op) {
+    size_t total = op->data.size();
+    std::vector<aio::Request> batch;
+    batch.reserve((total + ASYNC_CHUNK_SIZE - 1) / ASYNC_CHUNK_SIZE);
+    for (size_t offset = 0; offset < total; offset += ASYNC_CHUNK_SIZE) {
+        batch.push_back(asyncChunk(op, offset, std::min(ASYNC_CHUNK_SIZE, total - offset)));
+    }
+    op->pending.store(batch.size(), std::memory_order_release);
+    aio::Engine::instance().submit(batch);
+}
+
+#endif // LJOS_AIO_POSIX
+
+template <typename T>
+std::shared_future<T> readyFuture(T value) {
+    std::promise<T> promise;
+    promise.set_value(std::move(value));
+    return promise.get_future().share();
+}
+
+} // namespace detail
+
+// 异步读取整个文件
+inline std::shared_future<std::optional<std::string>> readFileAsync(const std::string& path) {
+#if defined(LJOS_AIO_POSIX)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return detail::readyFuture<std::optional<std::string>>(std::nullopt);
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        // 管道、/proc 等无法预知大小的文件在后台线程中流式读取
+        ::close(fd);
+        return std::async(std::launch::async, [path] { return readFile(path); }).share();
+    }
+    auto op = std::make_shared<detail::AsyncFileOp>();
+    op->fd = fd;
+    op->data.resize(static_cast<size_t>(st.st_size));
+    op->end.store(op->data.size(), std::memory_order_relaxed);
+    auto future = op->readResult.get_future().share();
+    detail::submitAsyncChunks(op);
+    return future;
+#else
+    return std::async(std::launch::async, [path] { return readFile(path); }).share();
+#endif
+}
+
+// 异步写入文件（覆盖），内容在提交前复制，调用方无需保持其存活
+inline std::shared_future<bool> writeFileAsync(const std::string& path, const std::string& content) {
+#if defined(LJOS_AIO_POSIX)
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return detail::readyFuture(false);
+    if (content.empty()) {
+        ::close(fd);
+        return detail::readyFuture(true);
+    }
+    auto op = std::make_shared<detail::AsyncFileOp>();
+    op->fd = fd;
+    op->writing = true;
+    op->data = content;
+    auto future = op->writeResult.get_future().share();
+    detail::submitAsyncChunks(op);
+    return future;
+#else
+    return std::async(std::launch::async, [path, content] { return writeFile(path, content); }).share();
+#endif
+}
+
+// ============ 缓冲写入句柄 ============
+
+// 持久化策略
+enum class Durability {
+    None,         // 只写入内核页缓存
+    SyncOnClose,  // close() 时 fdatasync
+    GroupCommit   // 写入后最迟 groupCommitMs 内由后台线程落盘（每个间隔最多一次），close() 时再同步
+};
+
+struct WriterOptions {
+    size_t bufferSize = 64 * 1024;
+    bool append = false;
+    Durability durability = Durability::None;
+    int groupCommitMs = 100;
+};
+
+namespace detail {
+
+// Writer 的全部状态；组提交模式下与后台提交线程共享
+struct WriterState {
+    WriterOptions options;
+    std::string buffer;
+    std::chrono::steady_clock::time_point lastSync;
+    bool dirty = false;  // 上次同步之后有新写入
+    bool failed = false;
+#ifdef LJOS_FS_POSIX
+    int fd = -1;
+#else
+    std::FILE* file = nullptr;
+#endif
+    std::mutex mutex;      // 保护以上字段
+    std::mutex syncMutex;  // 落盘期间持有：close() 要等它结束才能关闭文件
+
+    bool isOpen() const {
+#ifdef LJOS_FS_POSIX
+        return fd >= 0;
+#else
+        return file != nullptr;
+#endif
+    }
+
+    bool writeOut(const char* data, size_t size) {
+#ifdef LJOS_FS_POSIX
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                failed = true;
+                return false;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+#else
+        if (std::fwrite(data, 1, size, file) != size) {
+            failed = true;
+            return false;
+        }
+        return true;
+#endif
+    }
+
+    // 把用户态缓冲写出到内核（调用方持有 mutex）
+    bool flushBuffer() {
+        if (buffer.empty()) return !failed;
+        bool ok = writeOut(buffer.data(), buffer.size());
+        buffer.clear();
+        return ok;
+    }
+
+    // 落盘（调用方持有 syncMutex；写入可以同时进行）
+    bool syncFile() {
+#ifdef LJOS_FS_POSIX
+#if defined(__linux__)
+        return ::fdatasync(fd) == 0;
+#else
+        return ::fsync(fd) == 0;
+#endif
+#else
+        return std::fflush(file) == 0;
+#endif
+    }
+
+    // flush 并落盘；force 为 false 时只处理有新写入的句柄（后台提交线程使用）
+    bool sync(bool force) {
+        std::lock_guard<std::mutex> syncLock(syncMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!isOpen()) return false;
+            if (!force && !dirty) return !failed;
+            dirty = false;
+            lastSync = std::chrono::steady_clock::now();
+            if (!flushBuffer()) return false;
+        }
+        if (syncFile()) return true;
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = true;
+        return false;
+    }
+};
+
+// 组提交的后台线程：写入只把句柄标记为脏，这里在 groupCommitMs 到期时 flush 并 fdatasync，
+// 写完就不再写的句柄也会在一个间隔内落盘
+class WriterCommitter {
+public:
+    static WriterCommitter& instance() {
+        static WriterCommitter committer;
+        return committer;
+    }
+
+    WriterCommitter(const WriterCommitter&) = delete;
+    WriterCommitter& operator=(const WriterCommitter&) = delete;
+
+    // 退出前同步所有仍在等待的句柄
+    ~WriterCommitter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_one();
+        if (worker_.joinable()) worker_.join();
+    }
+
+    // 句柄由干净变脏时调用一次，deadline 为它最迟的落盘时间
+    void schedule(const std::shared_ptr<WriterState>& state, std::chrono::steady_clock::time_point deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!worker_.joinable()) worker_ = std::thread([this] { run(); });
+            pending_.push_back({state, deadline});
+        }
+        ready_.notify_one();
+    }
+
+private:
+    struct Pending {
+        std::weak_ptr<WriterState> state;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    WriterCommitter() = default;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            auto now = std::chrono::steady_clock::now();
+            auto next = std::chrono::steady_clock::time_point::max();
+            std::vector<std::shared_ptr<WriterState>> due;
+            for (auto it = pending_.begin(); it != pending_.end();) {
+                if (stopping_ || it->deadline <= now) {
+                    if (auto state = it->state.lock()) due.push_back(std::move(state));
+                    it = pending_.erase(it);
+                } else {
+                    next = std::min(next, it->deadline);
+                    ++it;
+                }
+            }
+            if (!due.empty()) {
+                lock.unlock();
+                for (auto& state : due) state->sync(false);
+                due.clear();
+                lock.lock();
+                continue;
+            }
+            if (stopping_) return;
+            if (next == std::chrono::steady_clock::time_point::max()) {
+                ready_.wait(lock);
+            } else {
+                ready_.wait_until(lock, next);
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::vector<Pending> pending_;
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+} // namespace detail
+
+// 保持文件打开的带缓冲写入器，避免每次写入都 open/close
+// 缓冲区写满、flush() 或析构时写出到内核；组提交模式下由后台线程按间隔落盘。
+// 状态在共享的 WriterState 里，句柄本身不可变：const 对象（Ljos 的 const 绑定）也可写入和关闭
+class Writer {
+public:
+    explicit Writer(const std::string& path, WriterOptions options = {})
+        : state_(std::make_shared<detail::WriterState>()) {
+        detail::WriterState& s = *state_;
+        s.options = options;
+        if (s.options.bufferSize == 0) s.options.bufferSize = 1;
+#ifdef LJOS_FS_POSIX
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (s.options.append ? O_APPEND : O_TRUNC);
+        s.fd = ::open(path.c_str(), flags, 0644);
+#else
+        s.file = std::fopen(path.c_str(), s.options.append ? "ab" : "wb");
+#endif
+        if (s.isOpen()) {
+            s.buffer.reserve(s.options.bufferSize);
+            s.lastSync = std::chrono::steady_clock::now();
+            // 先构造提交线程，保证它在本句柄之后析构
+            if (s.options.durability == Durability::GroupCommit) detail::WriterCommitter::instance();
+        }
+    }
+
+    ~Writer() { close(); }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    Writer(Writer&& other) noexcept = default;
+
+    bool isOpen() const {
+        if (!state_) return false;
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->isOpen();
+    }
+
+    // 写入数据；超过缓冲区的大块数据直接写出
+    bool write(std::string_view data) const {
+        if (!state_) return false;
+        detail::WriterState& s = *state_;
+        bool schedule = false;
+        std::chrono::steady_clock::time_point deadline;
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            if (!s.isOpen()) return false;
+            if (s.buffer.size() + data.size() > s.options.bufferSize) {
+                if (!s.flushBuffer()) return false;
+                if (data.size() >= s.options.bufferSize) {
+                    if (!s.writeOut(data.data(), data.size())) return false;
+                    data = {};
+                }
+            }
+            s.buffer.append(data.data(), data.size());
+            if (s.options.durability == Durability::GroupCommit && !s.dirty) {
+                // 距上次同步已超过间隔时立即落盘，否则在间隔到期时
+                s.dirty = true;
+                schedule = true;
+                deadline = std::max(s.lastSync + std::chrono::milliseconds(s.options.groupCommitMs),
+                                    std::chrono::steady_clock::now());
+            }
+        }
+        if (schedule) detail::WriterCommitter::instance().schedule(state_, deadline);
+        return true;
+    }
+
+    bool writeLine(std::string_view line) const {
+        return write(line) && write("\n");
+    }
+
+    // 把用户态缓冲写出到内核
+    bool flush() const {
+        if (!state_) return false;
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->isOpen()) return false;
+        return state_->flushBuffer();
+    }
+
+    // flush 并把数据落盘
+    bool sync() const {
+        return state_ && state_->sync(true);
+    }
+
+    // 关闭文件；按策略决定是否同步
+    bool close() const {
+        if (!state_) return false;
+        detail::WriterState& s = *state_;
+        bool ok = s.options.durability == Durability::None ? flush() : sync();
+        std::lock_guard<std::mutex> syncLock(s.syncMutex);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (!s.isOpen()) return false;
+#ifdef LJOS_FS_POSIX
+        ok = (::close(s.fd) == 0) && ok;
+        s.fd = -1;
+#else
+        ok = (std::fclose(s.file) == 0) && ok;
+        s.file = nullptr;
+#endif
+        return ok && !s.failed;
+    }
+
+private:
+    std::shared_ptr<detail::WriterState> state_;
+};
+
+// Ljos 侧持久化策略常量（与 std/fs.lj 一致）
+constexpr int SYNC_NONE = 0;
+constexpr int SYNC_ON_CLOSE = 1;
+constexpr int SYNC_GROUP = 2;
+
+// 打开写入句柄（Ljos: openWriter(path, append, durability, bufferSize, intervalMs)）
+inline Writer openWriter(const std::string& path, bool append = false, int durability = SYNC_NONE,
+                         long long bufferSize = 64 * 1024, int intervalMs = 100) {
+    WriterOptions options;
+    options.append = append;
+    options.bufferSize = bufferSize > 0 ? static_cast<size_t>(bufferSize) : 1;
+    options.groupCommitMs = intervalMs;
+    switch (durability) {
+        case SYNC_ON_CLOSE: options.durability = Durability::SyncOnClose; break;
+        case SYNC_GROUP: options.durability = Durability::GroupCommit; break;
+        default: options.durability = Durability::None; break;
+    }
+    return Writer(path, options);
+}
+
+// ============ 原子写入 ============
+// 先写同目录下的临时文件，再 rename 覆盖目标：任何时刻目标要么是旧内容，要么是新内容。
+// durability 复用 SYNC_* 常量：
+//   SYNC_NONE     只保证原子替换，不落盘（进程崩溃安全，断电可能丢失最近的写入）
+//   SYNC_ON_CLOSE 返回前 fdatasync 临时文件并 fsync 所在目录
+//   SYNC_GROUP    组提交：同一间隔内的所有原子写入共享一次落盘屏障
+
+namespace detail {
+
+inline std::string atomicTempPath(const std::string& path) {
+    static std::atomic<unsigned long long> counter{0};
+#ifdef LJOS_FS_POSIX
+    long pid = static_cast<long>(::getpid());
+#else
+    long pid = 0;
+#endif
+    return path + ".tmp." + std::to_string(pid) + "." + std::to_string(counter.fetch_add(1));
+}
+
+inline std::string parentDir(const std::string& path) {
+    std::string dir = stdfs::path(path).parent_path().string();
+    return dir.empty() ? "." : dir;
+}
+
+#ifdef LJOS_FS_POSIX
+
+inline bool syncFd(int fd) {
+#if defined(__linux__)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+inline bool syncDir(const std::string& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+// 写出临时文件（沿用目标文件的权限位）；sync 为 true 时关闭前落盘
+inline bool writeTempFile(const std::string& tmp, const std::string& path, const std::string& content, bool sync) {
+    mode_t mode = 0644;
+    struct ::stat st;
+    if (::stat(path.c_str(), &st) == 0) mode = st.st_mode & 07777;
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+    if (fd < 0) return false;
+    const char* p = content.data();
+    size_t left = content.size();
+    bool ok = true;
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ok = false;
+            break;
+        }
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    if (ok && sync) ok = syncFd(fd);
+    if (::close(fd) != 0) ok = false;
+    if (!ok) ::unlink(tmp.c_str());
+    return ok;
+}
+
+// 同一路径上的原子写入按调用顺序生效：每次写入在临时文件写好后领取序号，
+// rename 前检查是否已有序号更大的写入落位，若有则丢弃自己的临时文件。
+// 这样组提交中还在排队的旧写入不会覆盖之后同步完成的新写入。
+class RenameOrder {
+public:
+    static RenameOrder& instance() {
+        static RenameOrder order;
+        return order;
+    }
+
+    RenameOrder(const RenameOrder&) = delete;
+    RenameOrder& operator=(const RenameOrder&) = delete;
+
+    unsigned long long begin(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++paths_[path].outstanding;
+        return ++next_;
+    }
+
+    // 把 tmp rename 到 path；已被更晚的写入取代时只删除 tmp，仍视为成功（效果等同于先写入再被覆盖）
+    bool finish(const std::string& tmp, const std::string& path, unsigned long long seq) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = paths_[path];
+        bool ok = true;
+        if (seq < entry.renamed) {
+            ::unlink(tmp.c_str());
+        } else if (::rename(tmp.c_str(), path.c_str()) == 0) {
+            entry.renamed = seq;
+        } else {
+            ::unlink(tmp.c_str());
+            ok = false;
+        }
+        release(path, entry);
+        return ok;
+    }
+
+    // rename 之前就失败的写入：删除 tmp 并归还序号
+    void abandon(const std::string& tmp, const std::string& path) {
+        ::unlink(tmp.c_str());
+        std::lock_guard<std::mutex> lock(mutex_);
+        release(path, paths_[path]);
+    }
+
+private:
+    struct Entry {
+        unsigned long long renamed = 0;
+        size_t outstanding = 0;
+    };
+
+    RenameOrder() = default;
+
+    // 没有进行中的写入时不再需要记录该路径
+    void release(const std::string& path, Entry& entry) {
+        if (--entry.outstanding == 0) paths_.erase(path);
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> paths_;
+    unsigned long long next_ = 0;
+};
+
+// 组提交：后台线程每个间隔收集一批已写好的临时文件，
+// 通过 aio 引擎一次性提交所有 fdatasync（文件系统日志会把它们合并为一次提交），
+// 再依次 rename，最后每个目录只 fsync 一次。
+class GroupCommitter {
+public:
+    static GroupCommitter& instance() {
+        static GroupCommitter committer;
+        return committer;
+    }
+
+    GroupCommitter(const GroupCommitter&) = delete;
+    GroupCommitter& operator=(const GroupCommitter&) = delete;
+
+    ~GroupCommitter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        if (worker_.joinable()) worker_.join();
+    }
+
+    std::shared_future<bool> enqueue(std::string tmp, std::string path, unsigned long long seq) {
+        Pending item{std::move(tmp), std::move(path), seq, std::promise<bool>()};
+        std::shared_future<bool> future = item.done.get_future().share();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!worker_.joinable()) worker_ = std::thread([this] { run(); });
+            pending_.push_back(std::move(item));
+        }
+        ready_.notify_one();
+        return future;
+    }
+
+    void setInterval(int ms) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        intervalMs_ = ms > 0 ? ms : 0;
+    }
+
+private:
+    struct Pending {
+        std::string tmp;
+        std::string path;
+        unsigned long long seq;
+        std::promise<bool> done;
+    };
+
+    // 先构造 aio 引擎和 rename 顺序表，保证它们在本对象之后析构（析构时仍要提交剩余请求）
+    GroupCommitter() {
+        aio::Engine::instance();
+        RenameOrder::instance();
+    }
+
+    void run() {
+        for (;;) {
+            std::vector<Pending> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+                if (pending_.empty()) return;
+                // 第一个请求到达后再等一个间隔，让更多写入搭上同一次屏障
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(intervalMs_);
+                ready_.wait_until(lock, deadline, [this] { return stopping_; });
+                batch.swap(pending_);
+            }
+            commit(batch);
+        }
+    }
+
+    static void commit(std::vector<Pending>& batch) {
+        std::vector<int> fds(batch.size(), -1);
+        std::vector<std::future<long>> syncs(batch.size());
+        {
+            aio::Batch barrier(aio::Engine::instance());
+            for (size_t i = 0; i < batch.size(); ++i) {
+                fds[i] = ::open(batch[i].tmp.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fds[i] >= 0) syncs[i] = barrier.fsync(fds[i], true);
+            }
+        }
+        std::vector<bool> ok(batch.size(), false);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (fds[i] < 0) continue;
+            ok[i] = syncs[i].get() == 0;
+            ::close(fds[i]);
+        }
+        RenameOrder& order = RenameOrder::instance();
+        std::set<std::string> dirs;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!ok[i]) {
+                order.abandon(batch[i].tmp, batch[i].path);
+            } else if (order.finish(batch[i].tmp, batch[i].path, batch[i].seq)) {
+                dirs.insert(parentDir(batch[i].path));
+            } else {
+                ok[i] = false;
+            }
+        }
+        std::set<std::string> failedDirs;
+        for (const auto& dir : dirs) {
+            if (!syncDir(dir)) failedDirs.insert(dir);
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (ok[i] && !failedDirs.empty() && failedDirs.count(parentDir(batch[i].path))) ok[i] = false;
+            batch[i].done.set_value(ok[i]);
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::vector<Pending> pending_;
+    bool stopping_ = false;
+    int intervalMs_ = 10;
+    std::thread worker_;
+};
+
+#endif // LJOS_FS_POSIX
+
+} // namespace detail
+
+// 设置组提交间隔（毫秒）：越长每次屏障合并的写入越多，单次写入的确认延迟也越高
+inline void setGroupCommitInterval(int ms) {
+#ifdef LJOS_FS_POSIX
+    detail::GroupCommitter::instance().setInterval(ms);
+#else
+    (void)ms;
+#endif
+}
+
+// 原子写入，SYNC_GROUP 时立即返回，结果在本组落盘完成后就绪
+inline std::shared_future<bool> writeFileAtomicAsync(const std::string& path, const std::string& content,
+                                                     int durability = SYNC_GROUP) {
+    std::string tmp = detail::atomicTempPath(path);
+#ifdef LJOS_FS_POSIX
+    bool sync = durability == SYNC_ON_CLOSE;
+    if (!detail::writeTempFile(tmp, path, content, sync)) return detail::readyFuture(false);
+    unsigned long long seq = detail::RenameOrder::instance().begin(path);
+    if (durability == SYNC_GROUP) {
+        return detail::GroupCommitter::instance().enqueue(std::move(tmp), path, seq);
+    }
+    if (!detail::RenameOrder::instance().finish(tmp, path, seq)) return detail::readyFuture(false);
+    return detail::readyFuture(!sync || detail::syncDir(detail::parentDir(path)));
+#else
+    (void)durability;
+    {
+        std::ofstream file(tmp, std::ios::binary);
+        if (!file.is_open()) return detail::readyFuture(false);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+        file.flush();
+        if (!file.good()) {
+            file.close();
+            std::error_code ec;
+            stdfs::remove(tmp, ec);
+            return detail::readyFuture(false);
+        }
+    }
+    std::error_code ec;
+    stdfs::rename(tmp, path, ec);
+    if (ec) stdfs::remove(tmp, ec);
+    return detail::readyFuture(!ec);
+#endif
+}
+
+// 原子写入并等待其按 durability 完成
+inline bool writeFileAtomic(const std::string& path, const std::string& content, int durability = SYNC_ON_CLOSE) {
+    return writeFileAtomicAsync(path, content, durability).get();
+}
+
+// ============ 流式按行读取 ============
+
+// 分块读取文件并逐行产出 string_view，不为每行分配内存
+// 产出的行在下一次 next()（即下一次缓冲区填充）之前有效
+// 行尾的 '\n' 不包含在内，语义与 std::getline 一致
+class LineReader {
+public:
+    static constexpr size_t kDefaultChunkSize = 256 * 1024;
+    static constexpr size_t kAlignment = 4096;
+
+    explicit LineReader(const std::string& path, size_t chunkSize = kDefaultChunkSize)
+        : capacity_(chunkSize < kAlignment ? kAlignment : chunkSize) {
+#ifdef LJOS_FS_POSIX
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) return;
+#if defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#else
+        file_ = std::fopen(path.c_str(), "rb");
+        if (!file_) return;
+#endif
+        buffer_ = allocate(capacity_);
+    }
+
+    ~LineReader() {
+        close();
+        release(buffer_);
+    }
+
+    LineReader(const LineReader&) = delete;
+    LineReader& operator=(const LineReader&) = delete;
+
+    LineReader(LineReader&& other) noexcept
+        : buffer_(other.buffer_), capacity_(other.capacity_),
+          begin_(other.begin_), end_(other.end_), eof_(other.eof_),
+#ifdef LJOS_FS_POSIX
+          fd_(other.fd_) {
+        other.fd_ = -1;
+#else
+          file_(other.file_) {
+        other.file_ = nullptr;
+#endif
+        other.buffer_ = nullptr;
+        other.begin_ = other.end_ = 0;
+        other.eof_ = true;
+    }
+
+    bool isOpen() const { return buffer_ != nullptr; }
+
+    // 读取下一行；到达文件末尾返回 false
+    bool next(std::string_view& line) {
+        if (!buffer_) return false;
+        for (;;) {
+            const char* start = buffer_ + begin_;
+            size_t avail = end_ - begin_;
+            if (const void* nl = std::memchr(start, '\n', avail)) {
+                size_t len = static_cast<const char*>(nl) - start;
+                line = std::string_view(start, len);
+                begin_ += len + 1;
+                return true;
+            }
+            if (eof_) {
+                if (avail == 0) return false;
+                line = std::string_view(start, avail);
+                begin_ = end_;
+                return true;
+            }
+            refill();
+        }
     }
-    std::string line;
-    while (std::getline(file, line)) {
-        lines.push_back(line);
+
+    // 输入迭代器，支持 for (std::string_view line : reader)
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+        explicit iterator(LineReader* reader) : reader_(reader) { ++*this; }
+
+        reference operator*() const { return line_; }
+        pointer operator->() const { return &line_; }
+
+        iterator& operator++() {
+            if (reader_ && !reader_->next(line_)) reader_ = nullptr;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return reader_ == other.reader_; }
+        bool operator!=(const iterator& other) const { return reader_ != other.reader_; }
+
+    private:
+        LineReader* reader_ = nullptr;
+        std::string_view line_;
+    };
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    static char* allocate(size_t size) {
+        return static_cast<char*>(::operator new(size, std::align_val_t(kAlignment)));
+    }
+
+    static void release(char* p) {
+        if (p) ::operator delete(p, std::align_val_t(kAlignment));
+    }
+
+    void close() {
+#ifdef LJOS_FS_POSIX
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#else
+        if (file_) std::fclose(file_);
+        file_ = nullptr;
+#endif
+    }
+
+    // 把未消费的半行移到缓冲区开头（必要时扩容），再读入一整块
+    void refill() {
+        size_t pending = end_ - begin_;
+        if (pending == capacity_) {
+            // 单行超过缓冲区：扩容
+            char* grown = allocate(capacity_ * 2);
+            std::memcpy(grown, buffer_ + begin_, pending);
+            release(buffer_);
+            buffer_ = grown;
+            capacity_ *= 2;
+        } else if (begin_ > 0 && pending > 0) {
+            std::memmove(buffer_, buffer_ + begin_, pending);
+        }
+        begin_ = 0;
+        end_ = pending;
+
+        size_t n = readChunk(buffer_ + end_, capacity_ - end_);
+        if (n == 0) {
+            eof_ = true;
+            close();
+        }
+        end_ += n;
+    }
+
+    size_t readChunk(char* dst, size_t size) {
+#ifdef LJOS_FS_POSIX
+        for (;;) {
+            ssize_t n = ::read(fd_, dst, size);
+            if (n >= 0) return static_cast<size_t>(n);
+            if (errno != EINTR) return 0;
+        }
+#else
+        return std::fread(dst, 1, size, file_);
+#endif
+    }
+
+    char* buffer_ = nullptr;
+    size_t capacity_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+#ifdef LJOS_FS_POSIX
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+};
+
+// 按行惰性遍历文件：for (std::string_view line : lines(path))
+inline LineReader lines(const std::string& path) {
+    return LineReader(path);
+}
+
+// 按行读取文件
+inline std::vector<std::string> readLines(const std::string& path) {
+    std::vector<std::string> result;
+    LineReader reader(path);
+    std::string_view line;
+    while (reader.next(line)) {
+        result.emplace_back(line);
     }
-    return lines;
+    return result;
 }
 
 // ============ 文件信息 ============
 
+// 文件元数据（与 std/fs.lj 的 FileInfo 字段一致，时间为毫秒时间戳）
+struct FileInfo {
+    std::string path;
+    long long size = 0;
+    bool isFile = false;
+    bool isDir = false;
+    bool isSymlink = false;
+    long long createdAt = 0;
+    long long modifiedAt = 0;
+    long long accessedAt = 0;
+    unsigned int mode = 0;  // 权限位
+};
+
+#ifdef LJOS_FS_POSIX
+namespace detail {
+
+inline void fillKind(FileInfo& info, unsigned int mode) {
+    info.isFile = S_ISREG(mode);
+    info.isDir = S_ISDIR(mode);
+    info.isSymlink = S_ISLNK(mode);
+    info.mode = mode & 07777;
+}
+
+} // namespace detail
+#endif
+
+// 一次系统调用取回文件元数据；followSymlinks 为 false 时描述链接本身
+// Linux 上使用 statx，只请求需要的字段
+inline std::optional<FileInfo> stat(const std::string& path, bool followSymlinks = true) {
+    FileInfo info;
+    info.path = path;
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    struct statx stx;
+    int flags = AT_STATX_SYNC_AS_STAT | (followSymlinks ? 0 : AT_SYMLINK_NOFOLLOW);
+    unsigned int mask = STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME | STATX_ATIME | STATX_CTIME | STATX_BTIME;
+    if (::statx(AT_FDCWD, path.c_str(), flags, mask, &stx) != 0) {
+        return std::nullopt;
+    }
+    auto ms = [](const struct statx_timestamp& t) {
+        return static_cast<long long>(t.tv_sec) * 1000 + t.tv_nsec / 1000000;
+    };
+    detail::fillKind(info, stx.stx_mode);
+    info.size = static_cast<long long>(stx.stx_size);
+    info.modifiedAt = ms(stx.stx_mtime);
+    info.accessedAt = ms(stx.stx_atime);
+    info.createdAt = (stx.stx_mask & STATX_BTIME) ? ms(stx.stx_btime) : ms(stx.stx_ctime);
+#elif defined(LJOS_FS_POSIX)
+    struct ::stat st;
+    int rc = followSymlinks ? ::stat(path.c_str(), &st) : ::lstat(path.c_str(), &st);
+    if (rc != 0) {
+        return std::nullopt;
+    }
+    detail::fillKind(info, st.st_mode);
+    info.size = static_cast<long long>(st.st_size);
+    info.modifiedAt = static_cast<long long>(st.st_mtime) * 1000;
+    info.accessedAt = static_cast<long long>(st.st_atime) * 1000;
+    info.createdAt = static_cast<long long>(st.st_ctime) * 1000;
+#else
+    std::error_code ec;
+    auto st = followSymlinks ? stdfs::status(path, ec) : stdfs::symlink_status(path, ec);
+    if (ec || !stdfs::exists(st)) {
+        return std::nullopt;
+    }
+    info.isFile = stdfs::is_regular_file(st);
+    info.isDir = stdfs::is_directory(st);
+    info.isSymlink = stdfs::is_symlink(st);
+    info.mode = static_cast<unsigned int>(st.permissions()) & 07777;
+    if (info.isFile) {
+        info.size = static_cast<long long>(stdfs::file_size(path, ec));
+    }
+    auto mtime = stdfs::last_write_time(path, ec);
+    if (!ec) {
+        info.modifiedAt = std::chrono::duration_cast<std::chrono::milliseconds>(
+            mtime.time_since_epoch()).count();
+    }
+#endif
+    return info;
+}
+
+// 批量获取元数据；结果与 paths 一一对应，失败项为 nullopt
+inline std::vector<std::optional<FileInfo>> statMany(const std::vector<std::string>& paths,
+                                                     bool followSymlinks = true) {
+    std::vector<std::optional<FileInfo>> result;
+    result.reserve(paths.size());
+    for (const auto& path : paths) {
+        result.push_back(stat(path, followSymlinks));
+    }
+    return result;
+}
+
 // 检查文件是否存在
 inline bool exists(const std::string& path) {
-    return stdfs::exists(path);
+    return stat(path).has_value();
 }
 
 // 检查是否是文件
 inline bool isFile(const std::string& path) {
-    return stdfs::is_regular_file(path);
+    auto info = stat(path);
+    return info && info->isFile;
 }
 
 // 检查是否是目录
 inline bool isDir(const std::string& path) {
-    return stdfs::is_directory(path);
+    auto info = stat(path);
+    return info && info->isDir;
 }
 
-// 获取文件大小
+// 获取文件大小（只需一次 stat）；不存在或不是普通文件（如目录）返回 -1
 inline long long fileSize(const std::string& path) {
-    if (!stdfs::exists(path)) return -1;
-    return static_cast<long long>(stdfs::file_size(path));
+    auto info = stat(path);
+    return info && info->isFile ? info->size : -1;
 }
 
 // 获取文件扩展名
@@ -136,8 +1384,116 @@ inline std::vector<std::string> listDir(const std::string& path) {
     return entries;
 }
 
-// 复制文件
+#ifdef LJOS_FS_POSIX
+namespace detail {
+
+// 在两个已打开的描述符之间复制 size 字节
+// 依次尝试：FICLONE 共享数据块 -> copy_file_range -> sendfile -> read/write
+// 前一种方式不被支持（跨文件系统、内核过旧等）时从当前偏移继续用下一种
+inline bool copyFd(int in, int out, size_t size) {
+    size_t done = 0;
+#if defined(__linux__)
+#ifdef FICLONE
+    if (::ioctl(out, FICLONE, in) == 0) {
+        return true;
+    }
+#endif
+#ifdef __NR_copy_file_range
+    while (done < size) {
+        ssize_t n = ::syscall(__NR_copy_file_range, in, nullptr, out, nullptr, size - done, 0u);
+        if (n > 0) {
+            done += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        break;  // 0 表示源文件被截断；出错则换下一种方式
+    }
+    if (done == size) return true;
+#endif
+    while (done < size) {
+        ssize_t n = ::sendfile(out, in, nullptr, size - done);
+        if (n > 0) {
+            done += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        break;
+    }
+    if (done == size) return true;
+#else
+    (void)size;
+#endif
+    // 通用回退：用户态缓冲拷贝
+    if (::lseek(in, static_cast<off_t>(done), SEEK_SET) < 0 ||
+        ::lseek(out, static_cast<off_t>(done), SEEK_SET) < 0) {
+        return false;
+    }
+    std::unique_ptr<char[]> buf(new char[1 << 20]);
+    for (;;) {
+        ssize_t n = ::read(in, buf.get(), 1 << 20);
+        if (n == 0) return true;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        for (ssize_t off = 0; off < n;) {
+            ssize_t w = ::write(out, buf.get() + off, static_cast<size_t>(n - off));
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            off += w;
+        }
+    }
+}
+
+// 复制单个普通文件，保留权限位。
+// 与 std::filesystem::copy(overwrite_existing) 一致：已存在的普通文件被覆盖，
+// 目标是源文件本身或不是普通文件（目录、管道等）时失败
+inline bool copyRegularFile(const std::string& src, const std::string& dst) {
+    int in = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) return false;
+    struct stat st;
+    if (::fstat(in, &st) != 0) {
+        ::close(in);
+        return false;
+    }
+    struct stat existing;
+    if (::stat(dst.c_str(), &existing) == 0 &&
+        (!S_ISREG(existing.st_mode) || (existing.st_dev == st.st_dev && existing.st_ino == st.st_ino))) {
+        // O_TRUNC 会先清空同一个文件，管道会阻塞在 open 上
+        ::close(in);
+        return false;
+    }
+    int out = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 07777);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    // 覆盖已有文件时 open 不改变其权限位
+    ::fchmod(out, st.st_mode & 07777);
+    bool ok = copyFd(in, out, static_cast<size_t>(st.st_size));
+    ok = (::close(out) == 0) && ok;
+    ::close(in);
+    return ok;
+}
+
+} // namespace detail
+#endif
+
+// 复制文件；目标已存在时覆盖（与原先的 overwrite_existing 行为相同）
+// 普通文件在内核内完成复制（reflink / copy_file_range / sendfile），其余情况交给 std::filesystem
 inline bool copy(const std::string& src, const std::string& dst) {
+#ifdef LJOS_FS_POSIX
+    std::error_code ec;
+    if (stdfs::is_regular_file(src, ec)) {
+        std::string target = dst;
+        if (stdfs::is_directory(dst, ec)) {
+            target = (stdfs::path(dst) / stdfs::path(src).filename()).string();
+        }
+        return detail::copyRegularFile(src, target);
+    }
+#endif
     try {
         stdfs::copy(src, dst, stdfs::copy_options::overwrite_existing);
         return true;
@@ -146,6 +1502,63 @@ inline bool copy(const std::string& src, const std::string& dst) {
     }
 }
 
+// 递归复制目录树
+// 先按顺序建好目录结构，再由 threads 个工作线程并行复制文件（0 表示按 CPU 核数）
+inline bool copyTree(const std::string& src, const std::string& dst, int threads = 0) {
+    std::error_code ec;
+    if (!stdfs::is_directory(src, ec)) {
+        return copy(src, dst);
+    }
+
+    std::vector<std::pair<stdfs::path, stdfs::path>> files;
+    bool ok = true;
+    stdfs::create_directories(dst, ec);
+    if (ec) return false;
+
+    stdfs::path root(src);
+    for (auto it = stdfs::recursive_directory_iterator(root, ec);
+         !ec && it != stdfs::recursive_directory_iterator(); it.increment(ec)) {
+        const auto& entry = *it;
+        stdfs::path target = stdfs::path(dst) / entry.path().lexically_relative(root);
+        if (entry.is_symlink(ec)) {
+            stdfs::remove(target, ec);
+            stdfs::copy_symlink(entry.path(), target, ec);
+            if (ec) ok = false;
+        } else if (entry.is_directory(ec)) {
+            stdfs::create_directories(target, ec);
+            if (ec) ok = false;
+        } else {
+            files.emplace_back(entry.path(), std::move(target));
+        }
+        ec.clear();
+    }
+    if (ec) ok = false;
+
+    size_t workers = threads > 0 ? static_cast<size_t>(threads)
+                                 : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, files.size());
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> allCopied{true};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < files.size(); i = next.fetch_add(1)) {
+            if (!copy(files[i].first.string(), files[i].second.string())) {
+                allCopied = false;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < workers; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : pool) {
+        t.join();
+    }
+    return ok && allCopied;
+}
+
 // 移动/重命名文件
 inline bool move(const std::string& src, const std::string& dst) {
     try {
@@ -156,6 +1569,780 @@ inline bool move(const std::string& src, const std::string& dst) {
     }
 }
 
+// ============ 递归遍历 ============
+
+// 遍历产出的目录项；类型来自 d_type，无需再次 stat
+struct WalkEntry {
+    std::string path;
+    std::string name;
+    bool isFile = false;
+    bool isDir = false;
+    bool isSymlink = false;
+    int depth = 0;  // root 的直接子项为 1
+};
+
+struct WalkOptions {
+    int maxDepth = -1;                 // 最大深度，-1 不限制
+    std::vector<std::string> include;  // 名称通配（* ?），非空时只报告匹配项
+    std::vector<std::string> exclude;  // 名称通配，命中的目录不再深入
+    bool includeDirs = true;           // 是否报告目录本身
+    bool followSymlinks = false;       // 是否深入指向目录的符号链接（按 dev/ino 去环）
+    int threads = 0;                   // 工作线程数，0 表示按 CPU 核数
+};
+
+namespace detail {
+
+// 简单通配匹配：* 匹配任意串，? 匹配单个字符
+inline bool globMatch(std::string_view pattern, std::string_view name) {
+    size_t p = 0, n = 0, star = std::string_view::npos, mark = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            p++;
+            n++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            mark = n;
+        } else if (star != std::string_view::npos) {
+            p = star + 1;
+            n = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') p++;
+    return p == pattern.size();
+}
+
+inline bool matchesAny(const std::vector<std::string>& patterns, std::string_view name) {
+    for (const auto& pattern : patterns) {
+        if (globMatch(pattern, name)) return true;
+    }
+    return false;
+}
+
+enum class DirentKind { Unknown, File, Dir, Symlink, Other };
+
+// 读取一个目录的全部条目，回调 (name, kind)
+// Linux 上用 getdents64 批量读取；d_type 缺失时才 fstatat
+template<typename Fn>
+bool readDirEntries(const std::string& dir, Fn&& onEntry) {
+#if defined(__linux__) && defined(SYS_getdents64)
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct LinuxDirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+    alignas(8) char buf[64 * 1024];
+    for (;;) {
+        long n = ::syscall(SYS_getdents64, fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            ::close(fd);
+            return n == 0;
+        }
+        for (long off = 0; off < n;) {
+            auto* d = reinterpret_cast<LinuxDirent64*>(buf + off);
+            off += d->d_reclen;
+            const char* name = d->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+            DirentKind kind;
+            switch (d->d_type) {
+                case DT_REG: kind = DirentKind::File; break;
+                case DT_DIR: kind = DirentKind::Dir; break;
+                case DT_LNK: kind = DirentKind::Symlink; break;
+                case DT_UNKNOWN: {
+                    struct stat st;
+                    if (::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                        kind = DirentKind::Unknown;
+                    } else if (S_ISREG(st.st_mode)) {
+                        kind = DirentKind::File;
+                    } else if (S_ISDIR(st.st_mode)) {
+                        kind = DirentKind::Dir;
+                    } else if (S_ISLNK(st.st_mode)) {
+                        kind = DirentKind::Symlink;
+                    } else {
+                        kind = DirentKind::Other;
+                    }
+                    break;
+                }
+                default: kind = DirentKind::Other; break;
+            }
+            onEntry(std::string_view(name), kind);
+        }
+    }
+#elif defined(LJOS_FS_POSIX)
+    DIR* d = ::opendir(dir.c_str());
+    if (!d) return false;
+    while (struct dirent* e = ::readdir(d)) {
+        const char* name = e->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) continue;
+        DirentKind kind = DirentKind::Unknown;
+#ifdef DT_DIR
+        switch (e->d_type) {
+            case DT_REG: kind = DirentKind::File; break;
+            case DT_DIR: kind = DirentKind::Dir; break;
+            case DT_LNK: kind = DirentKind::Symlink; break;
+            case DT_UNKNOWN: break;
+            default: kind = DirentKind::Other; break;
+        }
+#endif
+        if (kind == DirentKind::Unknown) {
+            struct stat st;
+            std::string full = dir + "/" + name;
+            if (::lstat(full.c_str(), &st) == 0) {
+                kind = S_ISREG(st.st_mode) ? DirentKind::File
+                     : S_ISDIR(st.st_mode) ? DirentKind::Dir
+                     : S_ISLNK(st.st_mode) ? DirentKind::Symlink
+                     : DirentKind::Other;
+            }
+        }
+        onEntry(std::string_view(name), kind);
+    }
+    ::closedir(d);
+    return true;
+#else
+    std::error_code ec;
+    for (auto it = stdfs::directory_iterator(dir, ec); !ec && it != stdfs::directory_iterator(); it.increment(ec)) {
+        auto st = it->symlink_status(ec);
+        DirentKind kind = stdfs::is_regular_file(st) ? DirentKind::File
+                        : stdfs::is_directory(st) ? DirentKind::Dir
+                        : stdfs::is_symlink(st) ? DirentKind::Symlink
+                        : DirentKind::Other;
+        std::string name = it->path().filename().string();
+        onEntry(std::string_view(name), kind);
+    }
+    return !ec;
+#endif
+}
+
+// walk 的工作窃取调度：每个线程有自己的目录双端队列，
+// 自己从尾部取（深度优先、局部性好），空闲时从其他线程头部偷；
+// 偷不到就在条件变量上休眠，直到有新目录入队或全部完成
+class WalkScheduler {
+public:
+    struct Task {
+        std::string path;
+        int depth;
+    };
+
+    WalkScheduler(const WalkOptions& options, size_t workers)
+        : options_(options), queues_(workers), results_(workers) {}
+
+    std::vector<WalkEntry> run(const std::string& root) {
+        push(0, Task{root, 0});
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < queues_.size(); i++) {
+            pool.emplace_back([this, i]() { work(i); });
+        }
+        work(0);
+        for (auto& t : pool) t.join();
+
+        size_t total = 0;
+        for (const auto& r : results_) total += r.size();
+        std::vector<WalkEntry> all;
+        all.reserve(total);
+        for (auto& r : results_) {
+            std::move(r.begin(), r.end(), std::back_inserter(all));
+        }
+        return all;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(size_t self, Task task) {
+        pending_.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queues_[self].mutex);
+            queues_[self].tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1);
+        // 休眠者先登记再检查条件，这里先入队再读登记数，不会漏掉唤醒
+        if (sleepers_.load() > 0) {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            idle_.notify_one();
+        }
+    }
+
+    bool pop(size_t self, Task& out) {
+        {
+            std::lock_guard<std::mutex> lock(queues_[self].mutex);
+            if (!queues_[self].tasks.empty()) {
+                out = std::move(queues_[self].tasks.back());
+                queues_[self].tasks.pop_back();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        for (size_t k = 1; k < queues_.size(); k++) {
+            Queue& victim = queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(size_t self) {
+        Task task;
+        for (;;) {
+            if (pop(self, task)) {
+                scan(self, task);
+                if (pending_.fetch_sub(1) == 1) {
+                    // 最后一个目录处理完：叫醒所有休眠者退出
+                    std::lock_guard<std::mutex> lock(idleMutex_);
+                    idle_.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(idleMutex_);
+            sleepers_.fetch_add(1);
+            idle_.wait(lock, [this] { return queued_.load() > 0 || pending_.load() == 0; });
+            sleepers_.fetch_sub(1);
+            if (pending_.load() == 0) return;
+        }
+    }
+
+    // 第一次见到该目录时返回 true（仅 followSymlinks 时用于去环）
+    bool markVisited(const std::string& path) {
+#ifdef LJOS_FS_POSIX
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) return false;
+        std::lock_guard<std::mutex> lock(visitedMutex_);
+        return visited_.insert({static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino)}).second;
+#else
+        (void)path;
+        return true;
+#endif
+    }
+
+    void scan(size_t self, const Task& task) {
+        if (options_.followSymlinks && !markVisited(task.path)) return;
+        int depth = task.depth + 1;
+        if (options_.maxDepth >= 0 && depth > options_.maxDepth) return;  // maxDepth 为 0：不报告任何项
+        bool descend = options_.maxDepth < 0 || depth < options_.maxDepth;
+        std::string prefix = task.path;
+        if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+        readDirEntries(task.path, [&](std::string_view name, DirentKind kind) {
+            if (matchesAny(options_.exclude, name)) return;
+            std::string path = prefix;
+            path.append(name.data(), name.size());
+
+            bool isDir = kind == DirentKind::Dir;
+            bool isLink = kind == DirentKind::Symlink;
+            bool linkToDir = false;
+            if (isLink && options_.followSymlinks) {
+                std::error_code ec;
+                linkToDir = stdfs::is_directory(path, ec);
+            }
+            if ((isDir || linkToDir) && descend) {
+                push(self, Task{path, depth});
+            }
+            if (isDir && !options_.includeDirs) return;
+            if (!options_.include.empty() && !matchesAny(options_.include, name)) return;
+
+            WalkEntry entry;
+            entry.name.assign(name.data(), name.size());
+            entry.path = std::move(path);
+            entry.isFile = kind == DirentKind::File;
+            entry.isDir = isDir;
+            entry.isSymlink = isLink;
+            entry.depth = depth;
+            results_[self].push_back(std::move(entry));
+        });
+    }
+
+    const WalkOptions& options_;
+    std::vector<Queue> queues_;
+    std::vector<std::vector<WalkEntry>> results_;
+    std::atomic<size_t> pending_{0};  // 已入队但尚未处理完的目录
+    std::atomic<size_t> queued_{0};   // 仍在队列中等待的目录
+    std::atomic<size_t> sleepers_{0};
+    std::mutex idleMutex_;
+    std::condition_variable idle_;
+    std::mutex visitedMutex_;
+    std::set<std::pair<uint64_t, uint64_t>> visited_;
+};
+
+} // namespace detail
+
+// 并行递归遍历目录树；返回顺序不确定
+inline std::vector<WalkEntry> walk(const std::string& root, const WalkOptions& options = {}) {
+    std::error_code ec;
+    if (!stdfs::is_directory(root, ec)) return {};
+    size_t workers = options.threads > 0 ? static_cast<size_t>(options.threads)
+                                         : std::max(1u, std::thread::hardware_concurrency());
+    detail::WalkScheduler scheduler(options, workers);
+    return scheduler.run(root);
+}
+
+// Ljos 侧签名：walk(root, maxDepth, include, exclude)
+inline std::vector<WalkEntry> walk(const std::string& root, int maxDepth,
+                                   std::vector<std::string> include = {},
+                                   std::vector<std::string> exclude = {}) {
+    WalkOptions options;
+    options.maxDepth = maxDepth;
+    options.include = std::move(include);
+    options.exclude = std::move(exclude);
+    return walk(root, options);
+}
+
+// ============ 文件监视 ============
+// Linux 上基于 inotify 阻塞等待变化；其他平台按间隔扫描目录树比较快照。
+// 事件在一个短窗口内按路径合并后成批交给回调（或放入队列由 next() 取出）。
+
+// 事件类型（位掩码，同一批次内同一路径的多次变化合并为一个事件）
+constexpr int WATCH_CREATE = 1;
+constexpr int WATCH_MODIFY = 2;
+constexpr int WATCH_REMOVE = 4;
+constexpr int WATCH_RENAME = 8;
+constexpr int WATCH_OVERFLOW = 16;  // 内核事件队列溢出，部分事件已丢失，应重新扫描
+
+struct WatchEvent {
+    std::string path;
+    int kind = 0;
+    bool isDir = false;
+};
+
+struct WatchOptions {
+    bool recursive = true;      // 同时监视子目录（包括之后新建的）
+    int coalesceMs = 50;        // 第一个事件到达后最多等待多久再交付整批
+    int pollIntervalMs = 500;   // 无 inotify 的平台上的扫描间隔
+};
+
+using WatchCallback = std::function<void(const std::vector<WatchEvent>&)>;
+
+namespace detail {
+
+// 按路径合并一批事件，保持首次出现的顺序
+class WatchBatch {
+public:
+    void add(const std::string& path, int kind, bool isDir) {
+        auto it = index_.find(path);
+        if (it == index_.end()) {
+            index_.emplace(path, events_.size());
+            events_.push_back(WatchEvent{path, kind, isDir});
+        } else {
+            events_[it->second].kind |= kind;
+            events_[it->second].isDir = events_[it->second].isDir || isDir;
+        }
+    }
+
+    bool empty() const { return events_.empty(); }
+
+    std::vector<WatchEvent> take() {
+        std::vector<WatchEvent> out = std::move(events_);
+        events_.clear();
+        index_.clear();
+        return out;
+    }
+
+private:
+    std::vector<WatchEvent> events_;
+    std::unordered_map<std::string, size_t> index_;
+};
+
+class WatchState {
+public:
+    WatchState(std::string root, WatchCallback callback, const WatchOptions& options)
+        : root_(std::move(root)), callback_(std::move(callback)), options_(options) {
+        while (root_.size() > 1 && root_.back() == '/') root_.pop_back();
+        done_ = finished_.get_future().share();
+    }
+
+    WatchState(const WatchState&) = delete;
+    WatchState& operator=(const WatchState&) = delete;
+
+    ~WatchState() {
+        stop();
+#if defined(__linux__)
+        if (inotifyFd_ >= 0) ::close(inotifyFd_);
+        if (wakeFd_ >= 0) ::close(wakeFd_);
+#endif
+    }
+
+    bool start() {
+        std::error_code ec;
+        if (!stdfs::exists(root_, ec)) return false;
+#if defined(__linux__)
+        inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotifyFd_ < 0 || wakeFd_ < 0) return false;
+        if (options_.recursive && stdfs::is_directory(root_, ec)) {
+            addTree(root_, nullptr);
+        } else {
+            addWatch(root_);
+        }
+        if (watches_.empty()) return false;
+        worker_ = std::thread([this] {
+            markWorker();
+            runInotify();
+        });
+#else
+        snapshot(snapshot_);
+        worker_ = std::thread([this] {
+            markWorker();
+            runPolling();
+        });
+#endif
+        return true;
+    }
+
+    // 可在回调内部调用：此时只发出停止信号，线程在回调返回后退出，由持有者析构时回收
+    void stop() {
+        bool onWorker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            onWorker = workerId_ == std::this_thread::get_id();
+        }
+        changed_.notify_all();
+#if defined(__linux__)
+        if (wakeFd_ >= 0) {
+            uint64_t one = 1;
+            ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+            (void)n;
+        }
+#endif
+        if (!onWorker && worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    bool running() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !stopping_;
+    }
+
+    // 取出下一批事件；超时或已停止时返回空列表（timeoutMs < 0 表示一直等待）
+    std::vector<WatchEvent> next(int timeoutMs) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto ready = [this] { return stopping_ || !queue_.empty(); };
+        if (timeoutMs < 0) {
+            changed_.wait(lock, ready);
+        } else {
+            changed_.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+        }
+        if (queue_.empty()) return {};
+        std::vector<WatchEvent> batch = std::move(queue_.front());
+        queue_.pop_front();
+        return batch;
+    }
+
+    std::shared_future<void> done() const { return done_; }
+
+private:
+    void markWorker() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workerId_ = std::this_thread::get_id();
+    }
+
+    bool stopRequested() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stopping_;
+    }
+
+    // final 为真时是停止前的最后一批：即使已请求停止也照常交付
+    void deliver(std::vector<WatchEvent> batch, bool final = false) {
+        if (batch.empty() || (!final && stopRequested())) return;
+        if (callback_) {
+            callback_(batch);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(batch));
+        }
+        changed_.notify_all();
+    }
+
+    void finish() {
+        std::call_once(finishOnce_, [this] { finished_.set_value(); });
+    }
+
+    static std::string childPath(const std::string& dir, std::string_view name) {
+        std::string path = dir;
+        if (path.empty() || path.back() != '/') path += '/';
+        path.append(name.data(), name.size());
+        return path;
+    }
+
+#if defined(__linux__)
+    static constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM |
+                                           IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    void addWatch(const std::string& path) {
+        int wd = ::inotify_add_watch(inotifyFd_, path.c_str(), WATCH_MASK | IN_DONT_FOLLOW);
+        if (wd >= 0) watches_[wd] = path;
+    }
+
+    // 监视整棵子树；batch 非空时把已存在的内容补报为 CREATE
+    // （目录创建与添加监视之间写入的文件不会产生 inotify 事件）。
+    // 用显式工作表而非递归：readDirEntries 每层占用一个 64 KB 缓冲区和一个 fd，深层目录会栈溢出
+    void addTree(const std::string& root, WatchBatch* batch) {
+        std::vector<std::string> pending{root};
+        while (!pending.empty()) {
+            std::string dir = std::move(pending.back());
+            pending.pop_back();
+            addWatch(dir);
+            readDirEntries(dir, [&](std::string_view name, DirentKind kind) {
+                std::string path = childPath(dir, name);
+                bool isDir = kind == DirentKind::Dir;
+                if (batch) batch->add(path, WATCH_CREATE, isDir);
+                if (isDir) pending.push_back(std::move(path));
+            });
+        }
+    }
+
+    // 目录被移出监视范围后，撤销其下所有监视
+    void removeTree(const std::string& dir) {
+        std::string prefix = dir + "/";
+        for (auto it = watches_.begin(); it != watches_.end();) {
+            if (it->second == dir || it->second.compare(0, prefix.size(), prefix) == 0) {
+                ::inotify_rm_watch(inotifyFd_, it->first);
+                it = watches_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void parseEvents(const char* buf, size_t len, WatchBatch& batch) {
+        for (size_t off = 0; off < len;) {
+            const auto* ev = reinterpret_cast<const inotify_event*>(buf + off);
+            off += sizeof(inotify_event) + ev->len;
+            if (ev->mask & IN_Q_OVERFLOW) {
+                batch.add(root_, WATCH_OVERFLOW, true);
+                continue;
+            }
+            auto it = watches_.find(ev->wd);
+            if (it == watches_.end()) continue;
+            if (ev->mask & IN_IGNORED) {
+                watches_.erase(it);
+                continue;
+            }
+            std::string path = ev->len > 0 ? childPath(it->second, ev->name) : it->second;
+            bool isDir = (ev->mask & IN_ISDIR) != 0;
+            int kind = 0;
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO)) kind |= WATCH_CREATE;
+            if (ev->mask & (IN_MODIFY | IN_ATTRIB)) kind |= WATCH_MODIFY;
+            if (ev->mask & (IN_DELETE | IN_DELETE_SELF | IN_MOVED_FROM)) kind |= WATCH_REMOVE;
+            if (ev->mask & (IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF)) kind |= WATCH_RENAME;
+            // 子目录自身的 DELETE_SELF/MOVE_SELF 已由父目录报告
+            if ((ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) && path != root_) continue;
+            batch.add(path, kind, isDir);
+            if (isDir && options_.recursive) {
+                if (ev->mask & IN_MOVED_FROM) removeTree(path);
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO)) addTree(path, &batch);
+            }
+        }
+    }
+
+    void runInotify() {
+        using Clock = std::chrono::steady_clock;
+        alignas(inotify_event) char buf[64 * 1024];
+        WatchBatch batch;
+        Clock::time_point deadline;
+        pollfd fds[2];
+        fds[0].fd = inotifyFd_;
+        fds[0].events = POLLIN;
+        fds[1].fd = wakeFd_;
+        fds[1].events = POLLIN;
+        for (;;) {
+            int timeout = -1;
+            if (!batch.empty()) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+                timeout = static_cast<int>(std::max<long long>(0, left.count()));
+            }
+            int n = ::poll(fds, 2, timeout);
+            if (n < 0 && errno != EINTR) {
+                // 无法继续等待：标记为已停止，running() 不再报告一个已退出的监视
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                }
+                changed_.notify_all();
+                break;
+            }
+            if (n > 0 && (fds[0].revents & POLLIN)) {
+                for (;;) {
+                    ssize_t len = ::read(inotifyFd_, buf, sizeof(buf));
+                    if (len <= 0) break;
+                    bool wasEmpty = batch.empty();
+                    parseEvents(buf, static_cast<size_t>(len), batch);
+                    if (wasEmpty && !batch.empty()) {
+                        deadline = Clock::now() + std::chrono::milliseconds(options_.coalesceMs);
+                    }
+                }
+            }
+            if ((n > 0 && (fds[1].revents & POLLIN)) || stopRequested()) break;
+            if (!batch.empty() && Clock::now() >= deadline) {
+                deliver(batch.take());
+            }
+        }
+        // 停止前已合并但未到交付时间的事件不丢弃
+        deliver(batch.take(), true);
+        finish();
+    }
+
+    int inotifyFd_ = -1;
+    int wakeFd_ = -1;
+    std::unordered_map<int, std::string> watches_;
+#else
+    struct Snapshot {
+        long long size;
+        stdfs::file_time_type mtime;
+        bool isDir;
+    };
+
+    void snapshot(std::map<std::string, Snapshot>& out) {
+        out.clear();
+        auto record = [&](const stdfs::path& p) {
+            std::error_code ec;
+            auto status = stdfs::symlink_status(p, ec);
+            if (ec) return;
+            Snapshot s;
+            s.isDir = stdfs::is_directory(status);
+            s.size = s.isDir ? 0 : static_cast<long long>(stdfs::file_size(p, ec));
+            s.mtime = stdfs::last_write_time(p, ec);
+            out[p.string()] = s;
+        };
+        std::error_code ec;
+        if (!stdfs::is_directory(root_, ec)) {
+            record(root_);
+            return;
+        }
+        auto opts = stdfs::directory_options::skip_permission_denied;
+        if (options_.recursive) {
+            for (auto it = stdfs::recursive_directory_iterator(root_, opts, ec);
+                 !ec && it != stdfs::recursive_directory_iterator(); it.increment(ec)) {
+                record(it->path());
+            }
+        } else {
+            for (auto it = stdfs::directory_iterator(root_, opts, ec);
+                 !ec && it != stdfs::directory_iterator(); it.increment(ec)) {
+                record(it->path());
+            }
+        }
+    }
+
+    void runPolling() {
+        std::map<std::string, Snapshot> current;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                changed_.wait_for(lock, std::chrono::milliseconds(options_.pollIntervalMs),
+                                  [this] { return stopping_; });
+                if (stopping_) break;
+            }
+            snapshot(current);
+            WatchBatch batch;
+            for (const auto& [path, s] : current) {
+                auto it = snapshot_.find(path);
+                if (it == snapshot_.end()) {
+                    batch.add(path, WATCH_CREATE, s.isDir);
+                } else if (!s.isDir && (it->second.size != s.size || it->second.mtime != s.mtime)) {
+                    batch.add(path, WATCH_MODIFY, false);
+                }
+            }
+            for (const auto& [path, s] : snapshot_) {
+                if (current.find(path) == current.end()) batch.add(path, WATCH_REMOVE, s.isDir);
+            }
+            snapshot_.swap(current);
+            deliver(batch.take());
+        }
+        finish();
+    }
+
+    std::map<std::string, Snapshot> snapshot_;
+#endif
+
+    std::string root_;
+    WatchCallback callback_;
+    WatchOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<std::vector<WatchEvent>> queue_;
+    bool stopping_ = false;
+    std::thread worker_;
+    std::thread::id workerId_;
+
+    std::promise<void> finished_;
+    std::shared_future<void> done_;
+    std::once_flag finishOnce_;
+};
+
+} // namespace detail
+
+// 监视句柄；析构时停止监视。句柄本身不可变，const 对象也可 next()/close()
+class Watcher {
+public:
+    Watcher() = default;
+
+    // 是否仍在监视
+    bool isOpen() const { return state_ && state_->running(); }
+
+    // 未设置回调时，取出下一批事件（timeoutMs < 0 表示一直等待）
+    std::vector<WatchEvent> next(int timeoutMs = -1) const {
+        if (!state_) return {};
+        return state_->next(timeoutMs);
+    }
+
+    // 监视结束（close 被调用）时就绪，常驻进程可 wait().get() 阻塞主线程
+    std::shared_future<void> wait() const {
+        if (!state_) {
+            std::promise<void> ready;
+            ready.set_value();
+            return ready.get_future().share();
+        }
+        return state_->done();
+    }
+
+    // 停止监视；可在回调中调用
+    void close() const {
+        if (state_) state_->stop();
+    }
+
+private:
+    friend Watcher watch(const std::string& path, WatchCallback callback, const WatchOptions& options);
+
+    std::unique_ptr<detail::WatchState> state_;
+};
+
+// 开始监视 path（文件或目录）；callback 为空时事件放入队列，由 Watcher::next() 取出。
+// path 不存在或无法监视时返回未打开的 Watcher。
+inline Watcher watch(const std::string& path, WatchCallback callback, const WatchOptions& options = {}) {
+    Watcher watcher;
+    auto state = std::make_unique<detail::WatchState>(path, std::move(callback), options);
+    if (state->start()) watcher.state_ = std::move(state);
+    return watcher;
+}
+
+inline Watcher watch(const std::string& path, WatchCallback callback, bool recursive, int coalesceMs = 50) {
+    WatchOptions options;
+    options.recursive = recursive;
+    options.coalesceMs = coalesceMs;
+    return watch(path, std::move(callback), options);
+}
+
+// 队列模式：通过 next() 拉取事件批次
+inline Watcher openWatcher(const std::string& path, const WatchOptions& options = {}) {
+    return watch(path, nullptr, options);
+}
+
 // ============ 路径操作 ============
 
 // 连接路径
@@ -8,125 +8,472 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
 #include <sstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define LJOS_IO_POSIX 1
+#endif
+
+#include "fmt.hpp"
+#include "log.hpp"
 
 namespace ljos {
 namespace io {
 
 // ============ 标准输出 ============
-
-// println - 打印一行（使用 printf）
-inline void println() {
-    printf("\n");
-}
-
-inline void println(const std::string& s) {
-    printf("%s\n", s.c_str());
+// 所有 print/println 写入 Out：每个线程一块缓冲区，写满、flush() 或线程/进程退出时
+// 用一次 writev 交给内核。只有 stdout 是终端时才按行刷新，重定向到文件或管道时整块写出。
+
+namespace detail {
+
+constexpr size_t OUT_BUFFER_SIZE = 64 * 1024;
+
+class OutBuffer;
+
+} // namespace detail
+
+class Out {
+public:
+    static Out& instance() {
+        static Out out;
+        return out;
+    }
+
+    Out(const Out&) = delete;
+    Out& operator=(const Out&) = delete;
+
+    bool isTty() const { return tty_; }
+
+    inline void write(const char* data, size_t size);
+    void write(std::string_view s) { write(s.data(), s.size()); }
+    inline void put(char c);
+
+    // 写出当前线程的缓冲区
+    inline void flush();
+
+    // 终端上在读取输入前调用，保证提示信息可见
+    void flushIfTty() {
+        if (tty_) flush();
+    }
+
+    // 追加任意可打印值
+    template <typename T>
+    void append(const T& value) {
+        using V = std::decay_t<T>;
+        if constexpr (std::is_same_v<V, bool>) {
+            write(value ? std::string_view("true") : std::string_view("false"));
+        } else if constexpr (std::is_same_v<V, char>) {
+            put(value);
+        } else if constexpr (std::is_integral_v<V>) {
+            char buf[fmt::INT_BUFFER_SIZE];
+            write(buf, static_cast<size_t>(fmt::formatInt(buf, value) - buf));
+        } else if constexpr (std::is_floating_point_v<V>) {
+            char buf[fmt::FLOAT_BUFFER_SIZE];
+            write(buf, static_cast<size_t>(fmt::formatDouble(buf, value) - buf));
+        } else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+            write(std::string_view(value));
+        } else if constexpr (std::is_pointer_v<V>) {
+            char buf[24];
+            int n = std::snprintf(buf, sizeof(buf), "%p", static_cast<const void*>(value));
+            write(buf, static_cast<size_t>(n));
+        } else {
+            using std::to_string;
+            write(to_string(value));
+        }
+    }
+
+    template <typename... Args>
+    void print(const Args&... args) {
+        (append(args), ...);
+    }
+
+    template <typename... Args>
+    void println(const Args&... args) {
+        (append(args), ...);
+        put('\n');
+        if (tty_) flush();
+    }
+
+private:
+    friend class detail::OutBuffer;
+
+    Out() {
+#ifdef LJOS_IO_POSIX
+        tty_ = ::isatty(STDOUT_FILENO) == 1;
+#endif
+    }
+
+    inline detail::OutBuffer& buffer();
+
+    // 把缓冲区与可选的额外数据一次写出（额外数据不经过缓冲区复制）
+    void writeOut(const char* a, size_t aLen, const char* b, size_t bLen) {
+        if (aLen + bLen == 0) return;
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        // 先送出 stdio 中可能残留的内容，保持与 printf 等输出的先后顺序
+        std::fflush(stdout);
+#ifdef LJOS_IO_POSIX
+        iovec iov[2];
+        int count = 0;
+        if (aLen > 0) iov[count++] = iovec{const_cast<char*>(a), aLen};
+        if (bLen > 0) iov[count++] = iovec{const_cast<char*>(b), bLen};
+        iovec* cur = iov;
+        while (count > 0) {
+            ssize_t n = ::writev(STDOUT_FILENO, cur, count);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;  // EPIPE 等：丢弃输出
+            }
+            size_t done = static_cast<size_t>(n);
+            while (count > 0 && done >= cur->iov_len) {
+                done -= cur->iov_len;
+                ++cur;
+                --count;
+            }
+            if (count > 0) {
+                cur->iov_base = static_cast<char*>(cur->iov_base) + done;
+                cur->iov_len -= done;
+            }
+        }
+#else
+        if (aLen > 0) std::fwrite(a, 1, aLen, stdout);
+        if (bLen > 0) std::fwrite(b, 1, bLen, stdout);
+        std::fflush(stdout);
+#endif
+    }
+
+    bool tty_ = false;
+    std::mutex writeMutex_;
+};
+
+namespace detail {
+
+// 线程私有缓冲区，首次写入时分配；线程退出（主线程即进程退出）时自动写出
+class OutBuffer {
+public:
+    ~OutBuffer() { flush(); }
+
+    void flush() {
+        if (len_ > 0) {
+            Out::instance().writeOut(data_.get(), len_, nullptr, 0);
+            len_ = 0;
+        }
+    }
+
+    void write(const char* p, size_t n) {
+        if (!data_) data_.reset(new char[OUT_BUFFER_SIZE]);
+        if (n > OUT_BUFFER_SIZE - len_) {
+            if (n >= OUT_BUFFER_SIZE / 2) {
+                // 大块数据：与已缓冲内容一起 writev，不再复制
+                Out::instance().writeOut(data_.get(), len_, p, n);
+                len_ = 0;
+                return;
+            }
+            flush();
+        }
+        std::memcpy(data_.get() + len_, p, n);
+        len_ += n;
+    }
+
+    void put(char c) {
+        if (!data_) data_.reset(new char[OUT_BUFFER_SIZE]);
+        if (len_ == OUT_BUFFER_SIZE) flush();
+        data_[len_++] = c;
+    }
+
+private:
+    std::unique_ptr<char[]> data_;
+    size_t len_ = 0;
+};
+
+} // namespace detail
+
+inline detail::OutBuffer& Out::buffer() {
+    thread_local detail::OutBuffer buf;
+    return buf;
 }
 
-inline void println(const char* s) {
-    printf("%s\n", s);
+inline void Out::write(const char* data, size_t size) {
+    buffer().write(data, size);
 }
 
-inline void println(int n) {
-    printf("%d\n", n);
+inline void Out::put(char c) {
+    buffer().put(c);
 }
 
-inline void println(long n) {
-    printf("%ld\n", n);
+inline void Out::flush() {
+    buffer().flush();
 }
 
-inline void println(long long n) {
-    printf("%lld\n", n);
+// 标准输出 sink
+inline Out& out() {
+    return Out::instance();
 }
 
-inline void println(double n) {
-    printf("%g\n", n);
-}
-
-inline void println(bool b) {
-    printf("%s\n", b ? "true" : "false");
+// println - 打印一行（参数依次拼接）
+template <typename... Args>
+void println(const Args&... args) {
+    Out::instance().println(args...);
 }
 
 // print - 打印不换行
-inline void print(const std::string& s) {
-    printf("%s", s.c_str());
+template <typename... Args>
+void print(const Args&... args) {
+    Out::instance().print(args...);
 }
 
-inline void print(const char* s) {
-    printf("%s", s);
+// 立即写出当前线程缓冲的输出
+inline void flush() {
+    Out::instance().flush();
 }
 
-inline void print(int n) {
-    printf("%d", n);
-}
+// ============ 标准输入 ============
+// readln/readInt/readFloat 读取 Scanner：stdin 为普通文件时整体 mmap，否则按 1 MiB 块读入，
+// 在缓冲区内原地切分单词，数字用 from_chars 解析。读取 stdin 时不要再混用 std::cin。
 
-inline void print(double n) {
-    printf("%g", n);
-}
+namespace detail {
 
-inline void print(bool b) {
-    printf("%s", b ? "true" : "false");
-}
+constexpr size_t SCAN_BLOCK_SIZE = 1 << 20;
 
-// ============ 标准输入 ============
+inline bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
 
-// readln - 读取一行
+} // namespace detail
+
+class Scanner {
+public:
+    static Scanner& instance() {
+        static Scanner scanner(stdin);
+        return scanner;
+    }
+
+    explicit Scanner(std::FILE* file) : file_(file) {
+#ifdef LJOS_IO_POSIX
+        fd_ = ::fileno(file);
+        mapInput();
+#endif
+    }
+
+    ~Scanner() {
+#ifdef LJOS_IO_POSIX
+        if (map_) ::munmap(map_, mapSize_);
+#endif
+    }
+
+    Scanner(const Scanner&) = delete;
+    Scanner& operator=(const Scanner&) = delete;
+
+    // 输入是否已全部读完（会跳过空白，可能触发一次读取）
+    bool atEnd() {
+        skipSpace();
+        return pos_ >= end_;
+    }
+
+    // 下一个以空白分隔的单词；视图在下一次读取前有效
+    std::optional<std::string_view> token() {
+        skipSpace();
+        size_t len = 0;
+        for (;;) {
+            while (pos_ + len < end_ && !detail::isSpace(data_[pos_ + len])) ++len;
+            if (pos_ + len < end_ || !fill()) break;
+        }
+        if (len == 0) return std::nullopt;
+        std::string_view tok(data_ + pos_, len);
+        pos_ += len;
+        return tok;
+    }
+
+    // 当前位置到行尾（不含换行符）；视图在下一次读取前有效
+    std::optional<std::string_view> line() {
+        if (pos_ >= end_ && !fill()) return std::nullopt;
+        size_t len = 0;
+        const void* nl = nullptr;
+        for (;;) {
+            nl = std::memchr(data_ + pos_ + len, '\n', end_ - pos_ - len);
+            if (nl) break;
+            len = end_ - pos_;
+            if (!fill()) break;
+        }
+        if (nl) len = static_cast<size_t>(static_cast<const char*>(nl) - (data_ + pos_));
+        std::string_view text(data_ + pos_, len);
+        pos_ += len + (nl ? 1 : 0);
+        return text;
+    }
+
+    // 读取一个整数或浮点数；单词不以数字开头时返回空（单词仍被消耗）
+    template <typename T>
+    std::optional<T> next() {
+        static_assert(std::is_arithmetic_v<T>, "Scanner::next expects a number type");
+        auto tok = token();
+        if (!tok) return std::nullopt;
+        const char* first = tok->data();
+        const char* last = first + tok->size();
+        if (first < last && *first == '+') ++first;
+        T value{};
+        if constexpr (std::is_integral_v<T>) {
+            auto res = std::from_chars(first, last, value);
+            if (res.ptr == first) return std::nullopt;
+        } else {
+#ifdef LJOS_FMT_FLOAT_TO_CHARS
+            auto res = std::from_chars(first, last, value);
+            if (res.ptr == first) return std::nullopt;
+#else
+            std::string copy(first, last);
+            char* end = nullptr;
+            value = static_cast<T>(std::strtod(copy.c_str(), &end));
+            if (end == copy.c_str()) return std::nullopt;
+#endif
+        }
+        return value;
+    }
+
+private:
+#ifdef LJOS_IO_POSIX
+    // 普通文件直接映射剩余部分，之后不再有系统调用
+    void mapInput() {
+        struct stat st;
+        if (fd_ < 0 || ::fstat(fd_, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) return;
+        off_t offset = ::lseek(fd_, 0, SEEK_CUR);
+        if (offset < 0 || offset >= st.st_size) return;
+        void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (p == MAP_FAILED) return;
+        ::madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+        map_ = p;
+        mapSize_ = static_cast<size_t>(st.st_size);
+        data_ = static_cast<const char*>(p);
+        pos_ = static_cast<size_t>(offset);
+        end_ = mapSize_;
+        eof_ = true;
+    }
+#endif
+
+    void skipSpace() {
+        for (;;) {
+            while (pos_ < end_ && detail::isSpace(data_[pos_])) ++pos_;
+            if (pos_ < end_ || !fill()) return;
+        }
+    }
+
+    // 把未消费的部分移到缓冲区开头再读入一块；缓冲区满时翻倍。没有更多输入时返回 false
+    bool fill() {
+        if (eof_) return false;
+        size_t keep = end_ - pos_;
+        if (buffer_.empty()) buffer_.resize(detail::SCAN_BLOCK_SIZE);
+        if (keep > 0 && pos_ > 0) std::memmove(buffer_.data(), buffer_.data() + pos_, keep);
+        if (keep == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+        pos_ = 0;
+        end_ = keep;
+        data_ = buffer_.data();
+        size_t n = readSome(buffer_.data() + keep, buffer_.size() - keep);
+        if (n == 0) {
+            eof_ = true;
+            return false;
+        }
+        end_ += n;
+        return true;
+    }
+
+    size_t readSome(char* dst, size_t size) {
+#ifdef LJOS_IO_POSIX
+        for (;;) {
+            ssize_t n = ::read(fd_, dst, size);
+            if (n >= 0) return static_cast<size_t>(n);
+            if (errno != EINTR) return 0;
+        }
+#else
+        return std::fread(dst, 1, size, file_);
+#endif
+    }
+
+    [[maybe_unused]] std::FILE* file_;
+    int fd_ = -1;
+    void* map_ = nullptr;
+    size_t mapSize_ = 0;
+    std::vector<char> buffer_;
+    const char* data_ = nullptr;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+};
+
+// readln - 读取一行（不含换行符），输入结束时返回空字符串
 inline std::string readln() {
-    std::string line;
-    std::getline(std::cin, line);
-    return line;
+    Out::instance().flushIfTty();
+    auto text = Scanner::instance().line();
+    return text ? std::string(*text) : std::string();
 }
 
-// readInt - 读取整数
+// readInt - 读取下一个整数（以空白分隔），失败返回 0
 inline int readInt() {
-    int n;
-    std::cin >> n;
-    return n;
+    Out::instance().flushIfTty();
+    return Scanner::instance().next<int>().value_or(0);
 }
 
-// readFloat - 读取浮点数
+// readFloat - 读取下一个浮点数（以空白分隔），失败返回 0
 inline double readFloat() {
-    double n;
-    std::cin >> n;
-    return n;
+    Out::instance().flushIfTty();
+    return Scanner::instance().next<double>().value_or(0.0);
 }
 
 // ============ 标准错误 ============
 
-inline void eprintln(const std::string& s) {
-    fprintf(stderr, "%s\n", s.c_str());
+// 经由异步日志输出：调用方只复制到本线程的缓冲区，由日志线程成批写出
+template <typename... Args>
+inline void eprintln(const Args&... args) {
+    log::rawln(args...);
 }
 
-inline void eprint(const std::string& s) {
-    fprintf(stderr, "%s", s.c_str());
+template <typename... Args>
+inline void eprint(const Args&... args) {
+    log::raw(args...);
 }
 
 // ============ 格式化输出 ============
 
-// format - 格式化字符串
+// format - 格式化字符串（占位符同 JS 运行时：%s %d %i %f %o %b %%）
+// 运行期格式串单次扫描，直接追加到结果，不经过 snprintf
 template<typename... Args>
-std::string format(const std::string& fmt, Args... args) {
-    int size = snprintf(nullptr, 0, fmt.c_str(), args...) + 1;
-    if (size <= 0) return "";
-    std::unique_ptr<char[]> buf(new char[size]);
-    snprintf(buf.get(), size, fmt.c_str(), args...);
-    return std::string(buf.get(), buf.get() + size - 1);
+std::string format(std::string_view pattern, const Args&... args) {
+    std::string out;
+    out.reserve(pattern.size() + 16 * sizeof...(Args));
+    fmt::formatDynamicTo(out, pattern, args...);
+    return out;
+}
+
+// 编译期格式串：format(LJOS_FORMAT("x = %d"), x)，参数个数和类型在编译期检查
+template<typename Format, typename... Args, typename = std::enable_if_t<fmt::isFormat<Format>>>
+std::string format(Format f, const Args&... args) {
+    std::string out;
+    out.reserve(Format::text().size() + 16 * sizeof...(Args));
+    fmt::formatTo(out, f, args...);
+    return out;
 }
 
 // printf style
-template<typename... Args>
-void printf_fmt(const char* fmt, Args... args) {
-    printf(fmt, args...);
+template<typename Format, typename... Args>
+void printf_fmt(const Format& pattern, const Args&... args) {
+    print(format(pattern, args...));
 }
 
 // ============ 调试输出 ============
 
 template<typename T>
 T dbg(T value) {
-    std::cerr << "[DEBUG] " << value << std::endl;
+    log::rawln("[DEBUG] ", value);
     return value;
 }
 
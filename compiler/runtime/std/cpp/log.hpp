@@ -0,0 +1,507 @@
+/**
+ * Ljos Standard Library - Log Module (C++ Runtime)
+ * 异步日志：每个线程写入自己的无锁环形缓冲区，后台线程成批格式化并写到 stderr。
+ * 写日志的线程只做一次内存复制，不加锁、不进行系统调用。
+ * eprint/eprintln/dbg 的原样输出也进同一个缓冲区，与结构化记录保持先后顺序。
+ * 正常退出、quick_exit 和未捕获的异常都会先排空缓冲区；abort()、致命信号和 _exit
+ * 之前的输出需要保住时，用 setSync 打开同步模式。
+ */
+
+#ifndef LJOS_STD_LOG_HPP
+#define LJOS_STD_LOG_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <time.h>
+#include <unistd.h>
+#define LJOS_LOG_POSIX 1
+#endif
+
+#include "fmt.hpp"
+
+namespace ljos {
+namespace log {
+
+// ============ 级别与策略 ============
+
+constexpr int LEVEL_TRACE = 0;
+constexpr int LEVEL_DEBUG = 1;
+constexpr int LEVEL_INFO = 2;
+constexpr int LEVEL_WARN = 3;
+constexpr int LEVEL_ERROR = 4;
+constexpr int LEVEL_OFF = 5;
+
+// 缓冲区写满时：等待后台线程腾出空间，或丢弃本条并计数
+constexpr int BLOCK = 0;
+constexpr int DROP = 1;
+
+namespace detail {
+
+constexpr size_t RING_SIZE = 64 * 1024;       // 每个线程的环形缓冲区（2 的幂）
+constexpr size_t MAX_RECORD = RING_SIZE / 4;  // 更长的消息同步写出
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(5);
+
+enum class Kind : uint8_t { Log, Raw, Pad };
+
+// 记录布局：RecordHeader | int64 时间戳 | 消息，整体按 8 字节对齐
+struct RecordHeader {
+    uint32_t length;  // 消息字节数；Pad 记录为跳过的字节数
+    uint8_t level;
+    Kind kind;
+    uint16_t unused;
+};
+
+constexpr size_t RECORD_PREFIX = sizeof(RecordHeader) + sizeof(int64_t);
+
+constexpr size_t recordSize(size_t length) {
+    return (RECORD_PREFIX + length + 7) & ~size_t(7);
+}
+
+// 粗粒度时钟：Linux 上读 vDSO 中的缓存值，不进入内核
+inline int64_t coarseNow() {
+#if defined(__linux__)
+    timespec ts;
+    ::clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// 单生产者单消费者的字节环：生产者是所属线程，消费者是后台线程
+class Ring {
+public:
+    Ring() : buffer_(new char[RING_SIZE]) {}
+
+    bool tryPush(int level, Kind kind, int64_t time, std::string_view msg) {
+        size_t total = recordSize(msg.size());
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t offset = static_cast<size_t>(head & (RING_SIZE - 1));
+        size_t contiguous = RING_SIZE - offset;
+        size_t pad = contiguous < total ? contiguous : 0;
+        if (RING_SIZE - (head - tail_.load(std::memory_order_acquire)) < pad + total) return false;
+        if (pad > 0) {
+            // 尾部放不下整条记录：写一个跳过标记，从头开始
+            RecordHeader h{static_cast<uint32_t>(pad), 0, Kind::Pad, 0};
+            std::memcpy(buffer_.get() + offset, &h, sizeof(h));
+            head += pad;
+            offset = 0;
+        }
+        RecordHeader h{static_cast<uint32_t>(msg.size()), static_cast<uint8_t>(level), kind, 0};
+        char* p = buffer_.get() + offset;
+        std::memcpy(p, &h, sizeof(h));
+        std::memcpy(p + sizeof(h), &time, sizeof(time));
+        std::memcpy(p + RECORD_PREFIX, msg.data(), msg.size());
+        head_.store(head + total, std::memory_order_release);
+        return true;
+    }
+
+    bool halfFull() const {
+        return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed) > RING_SIZE / 2;
+    }
+
+    template <typename F>
+    void drain(F&& emit) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (tail < head) {
+            const char* p = buffer_.get() + (tail & (RING_SIZE - 1));
+            RecordHeader h;
+            std::memcpy(&h, p, sizeof(h));
+            if (h.kind == Kind::Pad) {
+                tail += h.length;
+                continue;
+            }
+            int64_t time;
+            std::memcpy(&time, p + sizeof(h), sizeof(time));
+            emit(h, time, std::string_view(p + RECORD_PREFIX, h.length));
+            tail += recordSize(h.length);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_relaxed);
+    }
+
+    void close() { closed_.store(true, std::memory_order_release); }
+    bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<char[]> buffer_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<bool> closed_{false};
+};
+
+// 线程退出时标记环已关闭，后台线程取完剩余记录后释放
+struct ThreadRing {
+    std::shared_ptr<Ring> ring;
+    ~ThreadRing() {
+        if (ring) ring->close();
+    }
+};
+
+inline void writeStderr(const char* data, size_t size) {
+#ifdef LJOS_LOG_POSIX
+    while (size > 0) {
+        ssize_t n = ::write(STDERR_FILENO, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+#else
+    std::fwrite(data, 1, size, stderr);
+    std::fflush(stderr);
+#endif
+}
+
+inline const char* levelName(int level) {
+    static const char* const names[] = {"TRACE", "DEBUG", "INFO ", "WARN ", "ERROR"};
+    return level >= LEVEL_TRACE && level < LEVEL_OFF ? names[level] : "?????";
+}
+
+// 同一秒内的日期时间部分只格式化一次
+struct TimeCache {
+    std::time_t second = -1;
+    char prefix[32] = {};
+    size_t length = 0;
+};
+
+// "2026-01-02 15:04:05.123 INFO  message\n"；Raw 记录原样输出
+inline void appendRecord(std::string& out, TimeCache& cache, int level, Kind kind, int64_t time,
+                         std::string_view msg) {
+    if (kind == Kind::Raw) {
+        out.append(msg);
+        return;
+    }
+    std::time_t seconds = static_cast<std::time_t>(time / 1000000000);
+    if (seconds != cache.second) {
+        std::tm tm{};
+#if defined(_WIN32)
+        localtime_s(&tm, &seconds);
+#else
+        localtime_r(&seconds, &tm);
+#endif
+        cache.length = std::strftime(cache.prefix, sizeof(cache.prefix), "%Y-%m-%d %H:%M:%S", &tm);
+        cache.second = seconds;
+    }
+    out.append(cache.prefix, cache.length);
+    int millis = static_cast<int>(time / 1000000 % 1000);
+    char buf[5] = {'.', static_cast<char>('0' + millis / 100), static_cast<char>('0' + millis / 10 % 10),
+                   static_cast<char>('0' + millis % 10), ' '};
+    out.append(buf, sizeof(buf));
+    out.append(levelName(level));
+    out.push_back(' ');
+    out.append(msg);
+    out.push_back('\n');
+}
+
+} // namespace detail
+
+// ============ Logger ============
+
+class Logger {
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // 进程退出时取完所有缓冲区再返回
+    ~Logger() {
+        active_.store(nullptr, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wakeCv_.notify_one();
+        if (worker_.joinable()) worker_.join();
+        stopped_.store(true, std::memory_order_release);
+    }
+
+    void setLevel(int level) { level_.store(level, std::memory_order_relaxed); }
+    int level() const { return level_.load(std::memory_order_relaxed); }
+    bool enabled(int level) const { return level >= this->level(); }
+
+    void setPolicy(int policy) { policy_.store(policy, std::memory_order_relaxed); }
+    int policy() const { return policy_.load(std::memory_order_relaxed); }
+
+    // DROP 策略下被丢弃的记录数
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 同步模式：每次写入后由调用线程取完所有缓冲区并写出，返回时记录已到达 stderr。
+    // 每条记录一次系统调用，只在需要在 abort() 或崩溃前保住输出时打开
+    void setSync(bool on) { sync_.store(on, std::memory_order_relaxed); }
+    bool sync() const { return sync_.load(std::memory_order_relaxed); }
+
+    // 写入一条记录：Log 由后台线程加上时间和级别，Raw 原样输出
+    void write(int level, detail::Kind kind, std::string_view msg) {
+        int64_t time = detail::coarseNow();
+        if (msg.size() > detail::MAX_RECORD || stopped_.load(std::memory_order_acquire)) {
+            // 超长消息不进环：先排空已有记录保持顺序，再直接写出
+            flush();
+            std::string line;
+            detail::TimeCache cache;
+            detail::appendRecord(line, cache, level, kind, time, msg);
+            detail::writeStderr(line.data(), line.size());
+            return;
+        }
+        detail::Ring& ring = localRing();
+        while (!ring.tryPush(level, kind, time, msg)) {
+            if (policy() == DROP) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wake();
+            std::this_thread::yield();
+        }
+        if (sync()) {
+            drainHere();
+        } else if (level >= LEVEL_ERROR || ring.halfFull()) {
+            wake();
+        }
+    }
+
+    // 等待此前写入的所有记录到达 stderr
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t target = passes_ + 2;
+        wake_ = true;
+        wakeCv_.notify_one();
+        doneCv_.wait(lock, [&] { return passes_ >= target || stop_; });
+    }
+
+    // std::terminate 时直接在当前线程取完所有缓冲区写到 stderr，不经过后台线程。
+    // 后台线程此时可能正在排空，只等它有限的时间。
+    // 会分配内存、加锁，不是异步信号安全的：不能从信号处理函数里调用
+    void drainNow() {
+        std::unique_lock<std::mutex> drainLock(drainMutex_, std::defer_lock);
+        std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+        if (!tryLockFor(drainLock) || !tryLockFor(lock)) return;
+        std::vector<std::shared_ptr<detail::Ring>> rings = rings_;
+        lock.unlock();
+        writeRings(rings);
+    }
+
+private:
+    Logger() : worker_([this] { run(); }) {
+        active_.store(this, std::memory_order_release);
+        previousTerminate_ = std::set_terminate(onTerminate);
+        std::at_quick_exit(onQuickExit);
+    }
+
+    // 同步模式下的写入：与后台线程互斥地取完所有缓冲区（包括其他线程的，保持先后顺序）
+    void drainHere() {
+        std::lock_guard<std::mutex> drainLock(drainMutex_);
+        std::vector<std::shared_ptr<detail::Ring>> rings;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings = rings_;
+        }
+        writeRings(rings);
+    }
+
+    // 调用方持有 drainMutex_
+    static void writeRings(const std::vector<std::shared_ptr<detail::Ring>>& rings) {
+        std::string batch;
+        detail::TimeCache cache;
+        for (auto& ring : rings) {
+            ring->drain([&](const detail::RecordHeader& h, int64_t time, std::string_view msg) {
+                detail::appendRecord(batch, cache, h.level, h.kind, time, msg);
+            });
+        }
+        if (!batch.empty()) detail::writeStderr(batch.data(), batch.size());
+    }
+
+    static bool tryLockFor(std::unique_lock<std::mutex>& lock) {
+        for (int i = 0; i < 100; ++i) {
+            if (lock.try_lock()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    // 未捕获的异常不会运行静态析构，缓冲中的记录（包括 eprintln 的输出）会丢失：
+    // 先排空再交给原来的 terminate 处理函数。致命信号不在这里处理，信号处理函数里
+    // 无法安全地加锁、分配和格式化
+    static void onTerminate() {
+        if (Logger* logger = active_.load(std::memory_order_acquire)) logger->drainNow();
+        if (previousTerminate_) previousTerminate_();
+        std::abort();
+    }
+
+    // quick_exit 同样跳过静态析构
+    static void onQuickExit() {
+        if (Logger* logger = active_.load(std::memory_order_acquire)) logger->drainNow();
+    }
+
+    detail::Ring& localRing() {
+        thread_local detail::ThreadRing local;
+        if (!local.ring) {
+            local.ring = std::make_shared<detail::Ring>();
+            std::lock_guard<std::mutex> lock(mutex_);
+            rings_.push_back(local.ring);
+        }
+        return *local.ring;
+    }
+
+    // 一轮排空之前只有第一次提醒需要加锁
+    void wake() {
+        if (wakePending_.exchange(true, std::memory_order_acq_rel)) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_ = true;
+        wakeCv_.notify_one();
+    }
+
+    void run() {
+        std::string batch;
+        detail::TimeCache cache;
+        uint64_t reportedDrops = 0;
+        for (;;) {
+            std::vector<std::shared_ptr<detail::Ring>> rings;
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wakeCv_.wait_for(lock, detail::DRAIN_INTERVAL, [&] { return wake_ || stop_; });
+                wake_ = false;
+                wakePending_.store(false, std::memory_order_release);
+                stopping = stop_;
+                rings = rings_;
+            }
+
+            std::unique_lock<std::mutex> drainLock(drainMutex_);
+            batch.clear();
+            for (auto& ring : rings) {
+                ring->drain([&](const detail::RecordHeader& h, int64_t time, std::string_view msg) {
+                    detail::appendRecord(batch, cache, h.level, h.kind, time, msg);
+                });
+            }
+            uint64_t drops = dropped();
+            if (drops != reportedDrops) {
+                detail::appendRecord(batch, cache, LEVEL_WARN, detail::Kind::Log, detail::coarseNow(),
+                                     fmt::concat("log: dropped ", drops - reportedDrops, " record(s), buffer full"));
+                reportedDrops = drops;
+            }
+            // 一轮只有一次系统调用
+            if (!batch.empty()) detail::writeStderr(batch.data(), batch.size());
+            drainLock.unlock();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                            [](const auto& r) { return r->closed() && r->empty(); }),
+                             rings_.end());
+                ++passes_;
+            }
+            doneCv_.notify_all();
+            if (stopping) return;
+        }
+    }
+
+    std::atomic<int> level_{LEVEL_INFO};
+    std::atomic<int> policy_{BLOCK};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> wakePending_{false};
+    std::atomic<bool> stopped_{false};
+    std::atomic<bool> sync_{false};
+
+    std::mutex mutex_;
+    std::mutex drainMutex_;  // 后台线程排空期间持有，与 drainNow、drainHere 互斥
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+    std::vector<std::shared_ptr<detail::Ring>> rings_;
+    bool wake_ = false;
+    bool stop_ = false;
+    uint64_t passes_ = 0;
+
+    std::thread worker_;
+
+    inline static std::atomic<Logger*> active_{nullptr};
+    inline static std::terminate_handler previousTerminate_ = nullptr;
+};
+
+namespace detail {
+
+// 拼接参数到线程私有的缓冲区（容量复用，稳定后不再分配）
+template <typename... Args>
+inline std::string_view compose(bool newline, const Args&... args) {
+    thread_local std::string scratch;
+    scratch.clear();
+    (fmt::appendTo(scratch, args), ...);
+    if (newline) scratch.push_back('\n');
+    return scratch;
+}
+
+} // namespace detail
+
+// ============ 日志接口 ============
+
+inline void setLevel(int level) { Logger::instance().setLevel(level); }
+inline int getLevel() { return Logger::instance().level(); }
+inline void setPolicy(int policy) { Logger::instance().setPolicy(policy); }
+inline long long dropped() { return static_cast<long long>(Logger::instance().dropped()); }
+inline void flush() { Logger::instance().flush(); }
+inline void setSync(bool on) { Logger::instance().setSync(on); }
+
+template <typename... Args>
+inline void log(int level, const Args&... args) {
+    Logger& logger = Logger::instance();
+    if (!logger.enabled(level)) return;
+    logger.write(level, detail::Kind::Log, detail::compose(false, args...));
+}
+
+template <typename... Args>
+inline void trace(const Args&... args) { log(LEVEL_TRACE, args...); }
+
+template <typename... Args>
+inline void debug(const Args&... args) { log(LEVEL_DEBUG, args...); }
+
+template <typename... Args>
+inline void info(const Args&... args) { log(LEVEL_INFO, args...); }
+
+template <typename... Args>
+inline void warn(const Args&... args) { log(LEVEL_WARN, args...); }
+
+template <typename... Args>
+inline void error(const Args&... args) { log(LEVEL_ERROR, args...); }
+
+// 不带时间和级别、不受级别过滤的原样输出（eprint/eprintln/dbg 使用）
+template <typename... Args>
+inline void raw(const Args&... args) {
+    Logger::instance().write(LEVEL_OFF, detail::Kind::Raw, detail::compose(false, args...));
+}
+
+template <typename... Args>
+inline void rawln(const Args&... args) {
+    Logger::instance().write(LEVEL_OFF, detail::Kind::Raw, detail::compose(true, args...));
+}
+
+} // namespace log
+} // namespace ljos
+
+#endif // LJOS_STD_LOG_HPP
@@ -8,9 +8,15 @@
 
 #include <cmath>
 #include <cstdlib>
-#include <random>
 #include <limits>
 #include <algorithm>
+#include <optional>
+#include <type_traits>
+
+#include "bigint.hpp"
+#include "primes.hpp"
+#include "random.hpp"
+#include "vecmath.hpp"
 
 namespace ljos {
 namespace math {
@@ -23,28 +29,98 @@ constexpr double TAU = 2 * PI;
 constexpr double SQRT2 = 1.41421356237309504880;
 constexpr double LN2 = 0.69314718055994530942;
 constexpr double LN10 = 2.30258509299404568402;
+constexpr double LOG2E = 1.44269504088896340736;
+constexpr double LOG10E = 0.43429448190325182765;
+constexpr double SQRT1_2 = 0.70710678118654752440;
+
+constexpr long long MAX_INT = 9007199254740991LL;
+constexpr long long MIN_INT = -9007199254740991LL;
+constexpr double MAX_FLOAT = std::numeric_limits<double>::max();
+constexpr double MIN_FLOAT = std::numeric_limits<double>::denorm_min();
+
+// INFINITY / NAN 是 <cmath> 的宏，std/math.lj 的同名常量由代码生成器映射到这里
+constexpr double INF = std::numeric_limits<double>::infinity();
+constexpr double NEG_INF = -std::numeric_limits<double>::infinity();
+constexpr double NOT_A_NUMBER = std::numeric_limits<double>::quiet_NaN();
 
 // ============ 基本函数 ============
+// 纯整数/算术函数标为 constexpr，可用于编译期常量；C++ 后端会把字面量参数的调用直接折叠
+
+namespace detail {
+
+template <typename T>
+constexpr bool isInteger = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+template <typename... Ts>
+using EnableIfArithmetic = std::enable_if_t<((std::is_arithmetic_v<Ts> && !std::is_same_v<Ts, bool>) && ...), int>;
+
+template <typename T>
+struct IdentityType {
+    using type = T;
+};
+
+// 不参与模板推导的参数类型：实参按 T 转换
+template <typename T>
+using Identity = typename IdentityType<T>::type;
+
+template <typename... Ts>
+using EnableIfInteger = std::enable_if_t<(isInteger<Ts> && ...), int>;
+
+// a < b；有符号与无符号整数混用时按数学值比较（同 C++20 std::cmp_less）
+template <typename A, typename B>
+constexpr bool less(A a, B b) {
+    if constexpr (isInteger<A> && isInteger<B> && std::is_signed_v<A> != std::is_signed_v<B>) {
+        if constexpr (std::is_signed_v<A>) {
+            return a < 0 || static_cast<std::make_unsigned_t<A>>(a) < b;
+        } else {
+            return b >= 0 && a < static_cast<std::make_unsigned_t<B>>(b);
+        }
+    } else {
+        return a < b;
+    }
+}
 
-inline double abs(double x) { return std::abs(x); }
-inline int abs(int x) { return std::abs(x); }
+} // namespace detail
+
+// abs / min / max / clamp 对每种整数与浮点类型各自实例化，不经过 double：
+// int64_t、uint64_t 在 2^53 以上也精确。参数类型不同时结果为 std::common_type
+// （int 与 double 得 double，int 与 int64_t 得 int64_t）
+
+template <typename T, detail::EnableIfArithmetic<T> = 0>
+constexpr T abs(T x) {
+    if constexpr (std::is_unsigned_v<T>) {
+        return x;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return x < T(0) ? -x : (x == T(0) ? T(0) : x); // -0.0 也得 +0.0
+    } else if (x == std::numeric_limits<T>::min()) {
+        return x; // 最小值取负会溢出（UB），没有可表示的结果，原样返回
+    } else {
+        return x < 0 ? static_cast<T>(-x) : x;
+    }
+}
 
 inline double floor(double x) { return std::floor(x); }
 inline double ceil(double x) { return std::ceil(x); }
 inline double round(double x) { return std::round(x); }
 inline double trunc(double x) { return std::trunc(x); }
 
-inline double min(double a, double b) { return std::min(a, b); }
-inline double max(double a, double b) { return std::max(a, b); }
-inline int min(int a, int b) { return std::min(a, b); }
-inline int max(int a, int b) { return std::max(a, b); }
+// 相等时返回第一个参数，与 std::min / std::max 一致
+template <typename A, typename B, detail::EnableIfArithmetic<A, B> = 0>
+constexpr std::common_type_t<A, B> min(A a, B b) {
+    using R = std::common_type_t<A, B>;
+    return detail::less(b, a) ? static_cast<R>(b) : static_cast<R>(a);
+}
 
-inline double clamp(double x, double lo, double hi) {
-    return std::max(lo, std::min(x, hi));
+template <typename A, typename B, detail::EnableIfArithmetic<A, B> = 0>
+constexpr std::common_type_t<A, B> max(A a, B b) {
+    using R = std::common_type_t<A, B>;
+    return detail::less(a, b) ? static_cast<R>(b) : static_cast<R>(a);
 }
 
-inline int clamp(int x, int lo, int hi) {
-    return std::max(lo, std::min(x, hi));
+template <typename T, typename L, typename H, detail::EnableIfArithmetic<T, L, H> = 0>
+constexpr std::common_type_t<T, L, H> clamp(T x, L lo, H hi) {
+    using R = std::common_type_t<T, L, H>;
+    return static_cast<R>(max(lo, min(x, hi)));
 }
 
 // ============ 幂和对数 ============
@@ -54,9 +130,11 @@ inline double sqrt(double x) { return std::sqrt(x); }
 inline double cbrt(double x) { return std::cbrt(x); }
 
 inline double exp(double x) { return std::exp(x); }
+inline double expm1(double x) { return std::expm1(x); }
 inline double log(double x) { return std::log(x); }
 inline double log2(double x) { return std::log2(x); }
 inline double log10(double x) { return std::log10(x); }
+inline double log1p(double x) { return std::log1p(x); }
 
 // ============ 三角函数 ============
 
@@ -73,50 +151,28 @@ inline double atan2(double y, double x) { return std::atan2(y, x); }
 inline double sinh(double x) { return std::sinh(x); }
 inline double cosh(double x) { return std::cosh(x); }
 inline double tanh(double x) { return std::tanh(x); }
+inline double asinh(double x) { return std::asinh(x); }
+inline double acosh(double x) { return std::acosh(x); }
+inline double atanh(double x) { return std::atanh(x); }
 
 // 角度转换
-inline double toRadians(double degrees) { return degrees * PI / 180.0; }
-inline double toDegrees(double radians) { return radians * 180.0 / PI; }
-
-// ============ 随机数 ============
-
-// 全局随机数生成器
-inline std::mt19937& getRandomEngine() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    return gen;
-}
-
-// 随机浮点数 [0, 1)
-inline double random() {
-    static std::uniform_real_distribution<double> dist(0.0, 1.0);
-    return dist(getRandomEngine());
-}
-
-// 随机整数 [min, max]
-inline int randomInt(int min, int max) {
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(getRandomEngine());
-}
+constexpr double toRadians(double degrees) { return degrees * PI / 180.0; }
+constexpr double toDegrees(double radians) { return radians * 180.0 / PI; }
 
-// 随机浮点数 [min, max)
-inline double randomFloat(double min, double max) {
-    std::uniform_real_distribution<double> dist(min, max);
-    return dist(getRandomEngine());
-}
+// ============ 其他函数 ============
 
-// 设置随机种子
-inline void seed(unsigned int s) {
-    getRandomEngine().seed(s);
-}
+inline double hypot(double x, double y) { return std::hypot(x, y); }
+inline double fmod(double x, double y) { return std::fmod(x, y); }
+constexpr double lerp(double a, double b, double t) { return a + (b - a) * t; }
 
 // ============ 数值检查 ============
 
 inline bool isNaN(double x) { return std::isnan(x); }
 inline bool isInf(double x) { return std::isinf(x); }
 inline bool isFinite(double x) { return std::isfinite(x); }
+inline bool isInfinite(double x) { return std::isinf(x); }
 
-inline int sign(double x) {
+constexpr int sign(double x) {
     if (x > 0) return 1;
     if (x < 0) return -1;
     return 0;
@@ -125,9 +181,9 @@ inline int sign(double x) {
 // ============ 整数运算 ============
 
 // 最大公约数
-inline int gcd(int a, int b) {
-    a = std::abs(a);
-    b = std::abs(b);
+constexpr int gcd(int a, int b) {
+    a = abs(a);
+    b = abs(b);
     while (b != 0) {
         int t = b;
         b = a % b;
@@ -137,44 +193,97 @@ inline int gcd(int a, int b) {
 }
 
 // 最小公倍数
-inline int lcm(int a, int b) {
+constexpr int lcm(int a, int b) {
     if (a == 0 || b == 0) return 0;
-    return std::abs(a / gcd(a, b) * b);
+    return abs(a / gcd(a, b) * b);
 }
 
-// 阶乘
-inline long long factorial(int n) {
-    if (n < 0) return 0;
-    if (n <= 1) return 1;
-    long long result = 1;
-    for (int i = 2; i <= n; i++) {
-        result *= i;
-    }
-    return result;
-}
-
-// 斐波那契
-inline long long fibonacci(int n) {
-    if (n <= 0) return 0;
-    if (n == 1) return 1;
-    long long a = 0, b = 1;
-    for (int i = 2; i <= n; i++) {
-        long long c = a + b;
-        a = b;
-        b = c;
-    }
-    return b;
+// 阶乘 factorial 与斐波那契 fibonacci 返回 BigInt，见 bigint.hpp
+
+// ============ 溢出控制的整数运算 ============
+// 基于编译器的溢出检测内建函数，按无穷精度计算后判断能否放进结果类型；
+// 结果类型与第一个操作数相同，第二个操作数可以是任意整数类型。
+//   xxxChecked：溢出（或除以零）时返回空
+//   xxxWrap：按补码回绕
+//   xxxSat：钳到结果类型的最小/最大值
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr std::optional<T> addChecked(T a, U b) {
+    T r{};
+    if (__builtin_add_overflow(a, b, &r)) return std::nullopt;
+    return r;
+}
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr std::optional<T> subChecked(T a, U b) {
+    T r{};
+    if (__builtin_sub_overflow(a, b, &r)) return std::nullopt;
+    return r;
+}
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr std::optional<T> mulChecked(T a, U b) {
+    T r{};
+    if (__builtin_mul_overflow(a, b, &r)) return std::nullopt;
+    return r;
 }
 
-// 是否为素数
-inline bool isPrime(int n) {
-    if (n < 2) return false;
-    if (n == 2) return true;
-    if (n % 2 == 0) return false;
-    for (int i = 3; i * i <= n; i += 2) {
-        if (n % i == 0) return false;
+// 截断除法；除数先转换为 T，除以零或 MIN / -1 时为空
+template <typename T, detail::EnableIfInteger<T> = 0>
+constexpr std::optional<T> divChecked(T a, detail::Identity<T> b) {
+    if (b == 0) return std::nullopt;
+    if constexpr (std::is_signed_v<T>) {
+        if (a == std::numeric_limits<T>::min() && b == -1) return std::nullopt;
     }
-    return true;
+    return static_cast<T>(a / b);
+}
+
+namespace detail {
+
+// 回绕运算在对应的无符号类型里做（至少 unsigned int，避免小类型提升成 int 后溢出）
+template <typename T>
+using WrapType = std::common_type_t<std::make_unsigned_t<T>, unsigned int>;
+
+} // namespace detail
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr T addWrap(T a, U b) {
+    using W = detail::WrapType<T>;
+    return static_cast<T>(static_cast<W>(a) + static_cast<W>(b));
+}
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr T subWrap(T a, U b) {
+    using W = detail::WrapType<T>;
+    return static_cast<T>(static_cast<W>(a) - static_cast<W>(b));
+}
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr T mulWrap(T a, U b) {
+    using W = detail::WrapType<T>;
+    return static_cast<T>(static_cast<W>(a) * static_cast<W>(b));
+}
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr T addSat(T a, U b) {
+    T r{};
+    if (!__builtin_add_overflow(a, b, &r)) return r;
+    return b > 0 ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+}
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr T subSat(T a, U b) {
+    T r{};
+    if (!__builtin_sub_overflow(a, b, &r)) return r;
+    return detail::less(b, 0) ? std::numeric_limits<T>::max() : std::numeric_limits<T>::min();
+}
+
+template <typename T, typename U, detail::EnableIfInteger<T, U> = 0>
+constexpr T mulSat(T a, U b) {
+    T r{};
+    if (!__builtin_mul_overflow(a, b, &r)) return r;
+    bool negative = detail::less(a, 0) != detail::less(b, 0);
+    return negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
 }
 
 } // namespace math
@@ -0,0 +1,420 @@
+/**
+ * Ljos Standard Library - Primes (C++ Runtime)
+ * 64 位确定性 Miller-Rabin 素性测试，L1 大小分段的奇数位图筛（可多线程），
+ * 以及按段惰性产出素数的迭代器。
+ */
+
+#ifndef LJOS_STD_PRIMES_HPP
+#define LJOS_STD_PRIMES_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace ljos {
+namespace math {
+
+// ============ 素性测试 ============
+
+namespace detail {
+
+constexpr uint64_t mulMod(uint64_t a, uint64_t b, uint64_t m) {
+#ifdef __SIZEOF_INT128__
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % m);
+#else
+    uint64_t result = 0;
+    a %= m;
+    while (b) {
+        if (b & 1) result = (result >= m - a) ? result - (m - a) : result + a;
+        a = (a >= m - a) ? a - (m - a) : a + a;
+        b >>= 1;
+    }
+    return result;
+#endif
+}
+
+constexpr uint64_t powMod(uint64_t base, uint64_t exp, uint64_t m) {
+    uint64_t result = 1;
+    base %= m;
+    while (exp) {
+        if (exp & 1) result = mulMod(result, base, m);
+        base = mulMod(base, base, m);
+        exp >>= 1;
+    }
+    return result;
+}
+
+// n - 1 = d·2^s，d 为奇数；返回 n 是否通过以 a 为底的强伪素数测试
+constexpr bool strongProbablePrime(uint64_t n, uint64_t d, int s, uint64_t a) {
+    a %= n;
+    if (a == 0) return true;
+    uint64_t x = powMod(a, d, n);
+    if (x == 1 || x == n - 1) return true;
+    for (int r = 1; r < s; r++) {
+        x = mulMod(x, x, n);
+        if (x == n - 1) return true;
+    }
+    return false;
+}
+
+constexpr uint32_t SMALL_PRIMES[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+
+// 这 7 个底对所有 n < 2^64 都是确定性的（Jim Sinclair）
+constexpr uint64_t MR_BASES[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+inline uint64_t isqrt(uint64_t n) {
+    uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (r > 0 && r > n / r) r--;
+    while ((r + 1) <= n / (r + 1)) r++;
+    return r;
+}
+
+} // namespace detail
+
+// 是否为素数，对全部 64 位整数确定；constexpr，可用于编译期常量
+constexpr bool isPrime(long long value) {
+    if (value < 2) return false;
+    uint64_t n = static_cast<uint64_t>(value);
+    if (n % 2 == 0) return n == 2;
+    for (uint32_t p : detail::SMALL_PRIMES) {
+        if (n % p == 0) return n == p;
+    }
+    if (n < 53 * 53) return true;
+
+    uint64_t d = n - 1;
+    int s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+    for (uint64_t a : detail::MR_BASES) {
+        if (!detail::strongProbablePrime(n, d, s, a)) return false;
+    }
+    return true;
+}
+
+// long long 能表示的最大素数（2^63 - 25）
+constexpr long long LARGEST_PRIME = 9223372036854775783LL;
+
+// 不小于 n 的最小素数（常用于哈希表容量、分片数）；n 超过 LARGEST_PRIME 时没有结果，返回 -1
+constexpr long long nextPrime(long long n) {
+    if (n <= 2) return 2;
+    if (n > LARGEST_PRIME) return -1;
+    if (n % 2 == 0) n++;
+    while (!isPrime(n)) n += 2;
+    return n;
+}
+
+// ============ 分段筛 ============
+
+namespace detail {
+
+// 每段一个 L1 数据缓存大小的位图，只存奇数
+constexpr size_t SIEVE_SEGMENT_BYTES = 32 * 1024;
+constexpr uint64_t SIEVE_SEGMENT_SPAN = SIEVE_SEGMENT_BYTES * 8 * 2;
+
+// 多线程筛在上界低于此值时不值得开线程
+constexpr uint64_t SIEVE_PARALLEL_MIN = uint64_t(1) << 24;
+
+// 区间下界超过此值时，√hi 以内的基素数表太大，改为逐个做 Miller-Rabin
+constexpr uint64_t SIEVE_MAX_START = uint64_t(1) << 44;
+
+// [3, limit] 内的奇素数，用来筛更大的区间
+inline std::vector<uint32_t> oddPrimesUpTo(uint32_t limit) {
+    std::vector<uint32_t> primes;
+    if (limit < 3) return primes;
+    std::vector<uint8_t> composite(limit / 2 + 1, 0);
+    for (uint64_t i = 3; i * i <= limit; i += 2) {
+        if (composite[i / 2]) continue;
+        for (uint64_t j = i * i; j <= limit; j += 2 * i) composite[j / 2] = 1;
+    }
+    for (uint32_t i = 3; i <= limit; i += 2) {
+        if (!composite[i / 2]) primes.push_back(i);
+    }
+    return primes;
+}
+
+} // namespace detail
+
+// 筛 [lo, hi)：每次处理一段，基素数按需扩充，因此 hi 可以很大（如迭代器的无界情形）
+class SegmentedSieve {
+public:
+    SegmentedSieve(uint64_t lo, uint64_t hi)
+        : next_(std::max<uint64_t>(lo, 3) | 1), hi_(hi), two_(lo <= 2 && hi > 2) {}
+
+    // 筛下一段，把其中的素数按升序交给 fn；已经筛完时返回 false
+    template <typename Fn>
+    bool nextSegment(Fn&& fn) {
+        if (two_) {
+            two_ = false;
+            fn(uint64_t(2));
+        }
+        if (!sieve()) return false;
+        for (size_t w = 0; w < words_.size(); w++) {
+            uint64_t bits = words_[w];
+            while (bits) {
+                fn(segLo_ + 2 * (w * 64 + static_cast<uint64_t>(__builtin_ctzll(bits))));
+                bits &= bits - 1;
+            }
+        }
+        return true;
+    }
+
+    // 同上，只计数
+    bool countSegment(uint64_t& count) {
+        if (two_) {
+            two_ = false;
+            count++;
+        }
+        if (!sieve()) return false;
+        for (uint64_t word : words_) count += static_cast<uint64_t>(__builtin_popcountll(word));
+        return true;
+    }
+
+private:
+    // 把 next_ 开始的一段奇数筛进 words_（置位 = 素数），第 i 位对应 segLo_ + 2i
+    bool sieve() {
+        if (next_ >= hi_) return false;
+        uint64_t lo = next_;
+        uint64_t hi = hi_ - lo > detail::SIEVE_SEGMENT_SPAN ? lo + detail::SIEVE_SEGMENT_SPAN : hi_;
+        next_ = hi;
+        segLo_ = lo;
+
+        uint64_t count = (hi - lo + 1) / 2;
+        words_.assign((count + 63) / 64, ~uint64_t(0));
+        if (count % 64) words_.back() = (uint64_t(1) << (count % 64)) - 1;
+
+        extendBase(hi);
+        for (size_t k = 0; k < base_.size(); k++) {
+            uint64_t p = base_[k];
+            if (p * p >= hi) break;
+            uint64_t i = (multiple_[k] - lo) / 2;
+            for (; i < count; i += p) words_[i / 64] &= ~(uint64_t(1) << (i % 64));
+            multiple_[k] = lo + 2 * i;
+        }
+        return true;
+    }
+
+    // 保证 base_ 含有所有 p·p < hi 的奇素数；新加入的素数从 max(p·p, 本段首个奇倍数) 开始划
+    void extendBase(uint64_t hi) {
+        uint64_t need = detail::isqrt(hi - 1);
+        if (need <= baseLimit_) return;
+        uint64_t limit = std::min<uint64_t>(std::max(need, baseLimit_ * 2), UINT32_MAX);
+        for (uint32_t p : detail::oddPrimesUpTo(static_cast<uint32_t>(limit))) {
+            if (p <= baseLimit_) continue;
+            uint64_t first = (segLo_ + p - 1) / p * p;
+            if (first % 2 == 0) first += p;
+            base_.push_back(p);
+            multiple_.push_back(std::max(first, uint64_t(p) * p));
+        }
+        baseLimit_ = limit;
+    }
+
+    uint64_t next_;
+    uint64_t hi_;
+    bool two_;
+    uint64_t segLo_ = 0;
+    uint64_t baseLimit_ = 0;
+    std::vector<uint64_t> words_;
+    std::vector<uint32_t> base_;
+    std::vector<uint64_t> multiple_;
+};
+
+namespace detail {
+
+inline unsigned sieveThreads(unsigned threads, uint64_t hi) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (hi < SIEVE_PARALLEL_MIN) return 1;
+    return threads;
+}
+
+// 把 [lo, hi) 按段边界切成 chunks 份交给多个线程，work(i, chunkLo, chunkHi) 写各自的结果槽
+template <typename Work>
+inline void parallelChunks(uint64_t lo, uint64_t hi, unsigned threads, size_t chunks, Work work) {
+    uint64_t span = (hi - lo + chunks - 1) / chunks;
+    span = (span + SIEVE_SEGMENT_SPAN - 1) / SIEVE_SEGMENT_SPAN * SIEVE_SEGMENT_SPAN;
+    std::vector<std::thread> pool;
+    std::atomic<size_t> nextChunk{0};
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&] {
+            for (size_t i; (i = nextChunk.fetch_add(1)) < chunks;) {
+                uint64_t a = std::min(hi, lo + i * span);
+                uint64_t b = std::min(hi, a + span);
+                work(i, a, b);
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+}
+
+} // namespace detail
+
+// ============ 批量接口 ============
+
+// [lo, hi] 内的全部素数
+inline std::vector<long long> primesInRange(long long lo, long long hi) {
+    std::vector<long long> out;
+    if (hi < 2 || hi < lo) return out;
+    lo = std::max(lo, 0LL);
+    if (static_cast<uint64_t>(lo) >= detail::SIEVE_MAX_START) {
+        for (long long n = nextPrime(lo); n <= hi && n > 0; n = nextPrime(n + 1)) out.push_back(n);
+        return out;
+    }
+    uint64_t from = static_cast<uint64_t>(lo);
+    uint64_t to = static_cast<uint64_t>(hi) + 1;
+    // 素数密度约 1 / (ln x - 1)，按区间宽度预留，之后基本不再扩容
+    double density = 1.0 / std::max(1.0, std::log(static_cast<double>(to)) - 1.1);
+    out.reserve(static_cast<size_t>(static_cast<double>(to - std::min(from, to)) * density) + 16);
+    SegmentedSieve sieve(from, to);
+    while (sieve.nextSegment([&](uint64_t p) { out.push_back(static_cast<long long>(p)); })) {
+    }
+    return out;
+}
+
+// 不超过 limit 的全部素数；threads 为 0 时使用全部核心，上界较小时总是单线程
+inline std::vector<long long> primesUpTo(long long limit, unsigned threads = 1) {
+    if (limit < 2) return {};
+    uint64_t hi = static_cast<uint64_t>(limit) + 1;
+    threads = detail::sieveThreads(threads, hi);
+    if (threads == 1) return primesInRange(2, limit);
+
+    size_t chunks = threads * 4;
+    std::vector<std::vector<long long>> parts(chunks);
+    detail::parallelChunks(0, hi, threads, chunks, [&](size_t i, uint64_t a, uint64_t b) {
+        if (a < b) parts[i] = primesInRange(static_cast<long long>(a), static_cast<long long>(b - 1));
+    });
+    size_t total = 0;
+    for (auto& part : parts) total += part.size();
+    std::vector<long long> out;
+    out.reserve(total);
+    for (auto& part : parts) out.insert(out.end(), part.begin(), part.end());
+    return out;
+}
+
+// 不超过 limit 的素数个数（只数位图，不生成数组）
+inline long long countPrimes(long long limit, unsigned threads = 1) {
+    if (limit < 2) return 0;
+    uint64_t hi = static_cast<uint64_t>(limit) + 1;
+    threads = detail::sieveThreads(threads, hi);
+    if (threads == 1) {
+        uint64_t count = 0;
+        SegmentedSieve sieve(0, hi);
+        while (sieve.countSegment(count)) {
+        }
+        return static_cast<long long>(count);
+    }
+
+    size_t chunks = threads * 4;
+    std::vector<uint64_t> counts(chunks, 0);
+    detail::parallelChunks(0, hi, threads, chunks, [&](size_t i, uint64_t a, uint64_t b) {
+        SegmentedSieve sieve(a, b);
+        while (sieve.countSegment(counts[i])) {
+        }
+    });
+    uint64_t total = 0;
+    for (uint64_t c : counts) total += c;
+    return static_cast<long long>(total);
+}
+
+// ============ PrimeIterator - 惰性产出 ============
+
+// 从 from 开始按升序逐个产出素数（to 为开区间上界，默认不设限），每次只筛一段。
+// 支持 next() 与 for (long long p : primes(...))；与 std/math.lj 的 PrimeIterator 一样是句柄，复制后共享进度
+class PrimeIterator {
+public:
+    explicit PrimeIterator(long long from = 2, long long to = LLONG_MAX)
+        : state_(std::make_shared<State>(std::max(from, 0LL), to)) {}
+
+    // 下一个素数，没有更多时返回空
+    std::optional<long long> next() const {
+        State& st = *state_;
+        if (st.trial) {
+            if (st.cursor >= st.to) return std::nullopt;
+            long long p = nextPrime(st.cursor);
+            if (p >= st.to || p <= 0) {
+                st.cursor = st.to;
+                return std::nullopt;
+            }
+            st.cursor = p + 1;
+            return p;
+        }
+        while (st.pos == st.buffer.size()) {
+            st.buffer.clear();
+            st.pos = 0;
+            if (!st.sieve.nextSegment([&](uint64_t p) { st.buffer.push_back(static_cast<long long>(p)); })) {
+                return std::nullopt;
+            }
+        }
+        return st.buffer[st.pos++];
+    }
+
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = long long;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const long long*;
+        using reference = const long long&;
+
+        iterator() = default;
+        explicit iterator(const PrimeIterator* owner) : owner_(owner) { ++*this; }
+
+        reference operator*() const { return value_; }
+        pointer operator->() const { return &value_; }
+
+        iterator& operator++() {
+            if (!owner_) return *this;
+            auto p = owner_->next();
+            if (p) {
+                value_ = *p;
+            } else {
+                owner_ = nullptr;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return owner_ == other.owner_; }
+        bool operator!=(const iterator& other) const { return owner_ != other.owner_; }
+
+    private:
+        const PrimeIterator* owner_ = nullptr;
+        long long value_ = 0;
+    };
+
+    iterator begin() const { return iterator(this); }
+    iterator end() const { return iterator(); }
+
+private:
+    struct State {
+        State(long long from, long long to)
+            : sieve(static_cast<uint64_t>(from), static_cast<uint64_t>(std::max(to, 0LL))), cursor(from), to(to),
+              trial(static_cast<uint64_t>(from) >= detail::SIEVE_MAX_START) {}
+
+        SegmentedSieve sieve;
+        std::vector<long long> buffer;
+        size_t pos = 0;
+        long long cursor;
+        long long to;
+        bool trial;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+// [from, to] 内的素数，惰性产出；省略 to 时不设上界
+inline PrimeIterator primes(long long from = 2, long long to = LLONG_MAX - 1) {
+    return PrimeIterator(from, to + 1);
+}
+
+} // namespace math
+} // namespace ljos
+
+#endif // LJOS_STD_PRIMES_HPP
@@ -0,0 +1,347 @@
+/**
+ * Ljos Standard Library - Random (C++ Runtime)
+ * 随机数引擎：xoshiro256++（默认）与 PCG64。random() 等全局函数使用线程局部引擎，
+ * 多线程调用互不加锁；需要可复现的并行序列时用 Rng 的 split() / jump() 切分子序列。
+ */
+
+#ifndef LJOS_STD_RANDOM_HPP
+#define LJOS_STD_RANDOM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace ljos {
+namespace math {
+
+namespace detail {
+
+inline uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+// splitmix64：把一个 64 位种子展开成引擎状态，相近的种子也得到不相关的状态
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+} // namespace detail
+
+// ============ xoshiro256++ ============
+
+// 周期 2^256 - 1，256 位状态；满足 UniformRandomBitGenerator，可直接配合 <random> 的分布使用
+class Xoshiro256pp {
+public:
+    using result_type = uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    explicit Xoshiro256pp(uint64_t seed = 0) { this->seed(seed); }
+
+    void seed(uint64_t seed) {
+        for (auto& word : s_) word = detail::splitMix64(seed);
+    }
+
+    result_type operator()() {
+        uint64_t result = detail::rotl(s_[0] + s_[3], 23) + s_[0];
+        uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = detail::rotl(s_[3], 45);
+        return result;
+    }
+
+    // 前进 2^128 步：连续 jump 得到 2^128 个互不重叠的子序列
+    void jump() { jumpBy(JUMP); }
+
+    // 前进 2^192 步，用于再上一层的划分（如每台机器一次 longJump，机器内每线程一次 jump）
+    void longJump() { jumpBy(LONG_JUMP); }
+
+    // 返回从当前位置开始的子序列，自身跳到 2^128 步之后
+    Xoshiro256pp split() {
+        Xoshiro256pp child = *this;
+        jump();
+        return child;
+    }
+
+    bool operator==(const Xoshiro256pp& other) const { return std::memcmp(s_, other.s_, sizeof(s_)) == 0; }
+    bool operator!=(const Xoshiro256pp& other) const { return !(*this == other); }
+
+private:
+    static constexpr uint64_t JUMP[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL,
+    };
+    static constexpr uint64_t LONG_JUMP[4] = {
+        0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL,
+    };
+
+    void jumpBy(const uint64_t (&poly)[4]) {
+        uint64_t t[4] = {};
+        for (uint64_t word : poly) {
+            for (int b = 0; b < 64; b++) {
+                if (word & (uint64_t(1) << b)) {
+                    for (int i = 0; i < 4; i++) t[i] ^= s_[i];
+                }
+                (*this)();
+            }
+        }
+        std::memcpy(s_, t, sizeof(s_));
+    }
+
+    uint64_t s_[4];
+};
+
+// ============ PCG64 ============
+
+#ifdef __SIZEOF_INT128__
+
+// PCG XSL-RR 128/64（与 NumPy 的 PCG64 相同的输出函数），周期 2^128；
+// 不同 stream 是互相独立的序列，advance() 以 O(log n) 跳过任意步数
+class Pcg64 {
+public:
+    using result_type = uint64_t;
+    using uint128 = unsigned __int128;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    explicit Pcg64(uint64_t seed = 0, uint64_t stream = 0) { this->seed(seed, stream); }
+
+    void seed(uint64_t seed, uint64_t stream = 0) {
+        uint64_t sm = seed;
+        uint128 initial = (uint128(detail::splitMix64(sm)) << 64) | detail::splitMix64(sm);
+        sm = stream;
+        inc_ = (((uint128(detail::splitMix64(sm)) << 64) | stream) << 1) | 1;
+        state_ = 0;
+        step();
+        state_ += initial;
+        step();
+    }
+
+    result_type operator()() {
+        step();
+        uint64_t hi = static_cast<uint64_t>(state_ >> 64);
+        uint64_t lo = static_cast<uint64_t>(state_);
+        unsigned rot = static_cast<unsigned>(hi >> 58);
+        uint64_t x = hi ^ lo;
+        return (x >> rot) | (x << ((64 - rot) & 63));
+    }
+
+    // 前进 delta 步
+    void advance(uint128 delta) {
+        uint128 mult = MULTIPLIER, plus = inc_;
+        uint128 accMult = 1, accPlus = 0;
+        while (delta > 0) {
+            if (delta & 1) {
+                accMult *= mult;
+                accPlus = accPlus * mult + plus;
+            }
+            plus = (mult + 1) * plus;
+            mult *= mult;
+            delta >>= 1;
+        }
+        state_ = accMult * state_ + accPlus;
+    }
+
+    // 前进 2^64 步
+    void jump() { advance(uint128(1) << 64); }
+
+    // 用当前序列的输出派生一个新 stream 上的生成器
+    Pcg64 split() {
+        uint64_t seed = (*this)();
+        uint64_t stream = (*this)();
+        return Pcg64(seed, stream);
+    }
+
+    bool operator==(const Pcg64& other) const { return state_ == other.state_ && inc_ == other.inc_; }
+    bool operator!=(const Pcg64& other) const { return !(*this == other); }
+
+private:
+    static constexpr uint128 MULTIPLIER =
+        (uint128(0x2360ed051fc65da4ULL) << 64) | 0x4385df649fccf645ULL;
+
+    void step() { state_ = state_ * MULTIPLIER + inc_; }
+
+    uint128 state_ = 0;
+    uint128 inc_ = 1;
+};
+
+#endif // __SIZEOF_INT128__
+
+// ============ 分布 ============
+
+namespace detail {
+
+// 取高 53 位，[0, 1) 上均匀
+inline double toUnit(uint64_t x) { return static_cast<double>(x >> 11) * 0x1.0p-53; }
+
+// [0, range) 上均匀（Lemire 乘法拒绝法，平均不到一次除法）
+template <typename Engine>
+inline uint64_t nextBelow(Engine& engine, uint64_t range) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 m = static_cast<unsigned __int128>(engine()) * range;
+    uint64_t low = static_cast<uint64_t>(m);
+    if (low < range) {
+        uint64_t threshold = (0 - range) % range;
+        while (low < threshold) {
+            m = static_cast<unsigned __int128>(engine()) * range;
+            low = static_cast<uint64_t>(m);
+        }
+    }
+    return static_cast<uint64_t>(m >> 64);
+#else
+    uint64_t limit = UINT64_MAX - UINT64_MAX % range;
+    uint64_t x;
+    do {
+        x = engine();
+    } while (x >= limit);
+    return x % range;
+#endif
+}
+
+// [min, max]，min > max 时交换
+template <typename Engine>
+inline long long nextInt(Engine& engine, long long min, long long max) {
+    if (min > max) std::swap(min, max);
+    uint64_t span = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+    if (span == UINT64_MAX) return static_cast<long long>(engine());
+    return static_cast<long long>(static_cast<uint64_t>(min) + nextBelow(engine, span + 1));
+}
+
+template <typename Engine>
+inline void fillUnit(Engine& engine, double* out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = toUnit(engine());
+}
+
+template <typename Engine, typename T>
+inline void fillInt(Engine& engine, T* out, size_t n, long long min, long long max) {
+    for (size_t i = 0; i < n; i++) out[i] = static_cast<T>(nextInt(engine, min, max));
+}
+
+// 全局种子。seed() 递增 generation，各线程下次取引擎时按新种子重新派生
+struct RandomState {
+    std::atomic<uint64_t> seed;
+    std::atomic<uint64_t> generation{0};
+    std::atomic<uint64_t> nextStream{0};
+
+    RandomState() {
+        std::random_device rd;
+        seed.store((uint64_t(rd()) << 32) ^ rd(), std::memory_order_relaxed);
+    }
+};
+
+inline RandomState& randomState() {
+    static RandomState state;
+    return state;
+}
+
+struct ThreadEngine {
+    Xoshiro256pp engine;
+    uint64_t generation = UINT64_MAX;
+};
+
+} // namespace detail
+
+// 当前线程的引擎：第 n 个取用引擎的线程得到种子序列 jump() n 次后的子序列
+inline Xoshiro256pp& getRandomEngine() {
+    thread_local detail::ThreadEngine local;
+    auto& state = detail::randomState();
+    uint64_t generation = state.generation.load(std::memory_order_acquire);
+    if (local.generation != generation) {
+        local.engine.seed(state.seed.load(std::memory_order_relaxed));
+        uint64_t stream = state.nextStream.fetch_add(1, std::memory_order_relaxed);
+        for (uint64_t i = 0; i < stream; i++) local.engine.jump();
+        local.generation = generation;
+    }
+    return local.engine;
+}
+
+// 设置种子：调用线程从子序列 0 重新开始，其他线程在下次取随机数时依次取得后续子序列
+inline void seed(uint64_t s) {
+    auto& state = detail::randomState();
+    state.seed.store(s, std::memory_order_relaxed);
+    state.nextStream.store(0, std::memory_order_relaxed);
+    state.generation.fetch_add(1, std::memory_order_release);
+}
+
+// 随机浮点数 [0, 1)
+inline double random() { return detail::toUnit(getRandomEngine()()); }
+
+// 随机整数 [min, max]
+inline int randomInt(int min, int max) {
+    return static_cast<int>(detail::nextInt(getRandomEngine(), min, max));
+}
+
+// 随机浮点数 [min, max)
+inline double randomFloat(double min, double max) { return min + random() * (max - min); }
+
+// 批量填充 [0, 1) 的随机数；引擎状态在循环内保持在寄存器里
+inline void fillRandom(double* out, size_t n) {
+    Xoshiro256pp& shared = getRandomEngine();
+    Xoshiro256pp engine = shared;
+    detail::fillUnit(engine, out, n);
+    shared = engine;
+}
+
+inline void fillRandom(std::vector<double>& out) { fillRandom(out.data(), out.size()); }
+
+// 批量填充 [min, max] 的随机整数
+inline void fillRandomInt(std::vector<int>& out, int min, int max) {
+    Xoshiro256pp& shared = getRandomEngine();
+    Xoshiro256pp engine = shared;
+    detail::fillInt(engine, out.data(), out.size(), min, max);
+    shared = engine;
+}
+
+// ============ Rng - 独立的随机数流 ============
+
+// 同一种子得到同一序列；split() 切出互不重叠的子序列，适合按任务分配给并行的模拟。
+// 与 std/math.lj 的 Rng 一样是句柄：复制后共享同一个引擎，const 绑定也可以取数
+template <typename Engine>
+class BasicRng {
+public:
+    // 不给种子时从当前线程的引擎取一个
+    BasicRng() : engine_(std::make_shared<Engine>(getRandomEngine()())) {}
+    explicit BasicRng(uint64_t seed) : engine_(std::make_shared<Engine>(seed)) {}
+    explicit BasicRng(Engine engine) : engine_(std::make_shared<Engine>(std::move(engine))) {}
+
+    double random() const { return detail::toUnit((*engine_)()); }
+    int randomInt(int min, int max) const { return static_cast<int>(detail::nextInt(*engine_, min, max)); }
+    double randomFloat(double min, double max) const { return min + random() * (max - min); }
+
+    void fill(std::vector<double>& out) const { detail::fillUnit(*engine_, out.data(), out.size()); }
+    void fillInt(std::vector<int>& out, int min, int max) const {
+        detail::fillInt(*engine_, out.data(), out.size(), min, max);
+    }
+
+    void jump() const { engine_->jump(); }
+    BasicRng split() const { return BasicRng(engine_->split()); }
+
+    Engine& engine() const { return *engine_; }
+
+private:
+    std::shared_ptr<Engine> engine_;
+};
+
+using Rng = BasicRng<Xoshiro256pp>;
+
+#ifdef __SIZEOF_INT128__
+using PcgRng = BasicRng<Pcg64>;
+#endif
+
+inline Rng newRng(uint64_t seed) { return Rng(seed); }
+
+} // namespace math
+} // namespace ljos
+
+#endif // LJOS_STD_RANDOM_HPP
@@ -0,0 +1,190 @@
+/**
+ * Ljos Standard Library - Multi-Pattern Replace (C++ Runtime)
+ * 多模式替换（replaceMany）：所有模式反转后编译成一个 Aho-Corasick 自动机，
+ * 从右往左扫描一遍得到每个位置起始的最长模式，再从左往右贪心选出匹配。
+ *   - 匹配规则为最左最长：同一位置取最长的模式，匹配之间不重叠，替换结果不再参与匹配
+ *   - 转移表按字节等价类压缩：不出现在任何模式里的字节共用一类
+ *   - 先收集匹配再按精确长度一次性构造结果
+ * Replacer 构造一次即可在任意多个字符串上重复使用。
+ */
+
+#ifndef LJOS_STD_REPLACER_HPP
+#define LJOS_STD_REPLACER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ljos {
+namespace str {
+
+class Replacer {
+public:
+    // pairs 为 (模式, 替换) 列表；空模式被忽略，重复的模式以第一次出现为准
+    explicit Replacer(const std::vector<std::pair<std::string, std::string>>& pairs) {
+        for (auto& c : class_) c = 0;
+        for (auto& l : last_) l = false;
+        for (const auto& [from, to] : pairs) {
+            if (!from.empty()) last_[static_cast<unsigned char>(from.back())] = true;
+            for (unsigned char c : from) {
+                if (class_[c] == 0) class_[c] = static_cast<uint16_t>(classes_++);
+            }
+        }
+        addState(0);
+        for (const auto& [from, to] : pairs) {
+            if (from.empty()) continue;
+            // 字典树按反转后的模式建立
+            uint32_t state = 0;
+            for (auto it = from.rbegin(); it != from.rend(); ++it) {
+                unsigned char c = static_cast<unsigned char>(*it);
+                size_t slot = state * classes_ + class_[c];
+                if (delta_[slot] == FAIL) {
+                    delta_[slot] = static_cast<uint32_t>(depth_.size());
+                    addState(depth_[state] + 1);
+                }
+                state = delta_[slot];
+            }
+            if (pattern_[state] == NONE) {
+                pattern_[state] = static_cast<uint32_t>(to_.size());
+                to_.push_back(to);
+            }
+        }
+        link();
+    }
+
+    // 模式个数（不含被忽略的）
+    size_t size() const { return to_.size(); }
+
+    std::string replace(std::string_view s) const {
+        std::vector<Match> found = matches(s);
+        if (found.empty()) return std::string(s);
+
+        size_t total = s.size();
+        for (const Match& m : found) total += to_[m.pattern].size() - (m.end - m.start);
+
+        std::string result;
+        result.reserve(total);
+        size_t copied = 0;
+        for (const Match& m : found) {
+            result.append(s.data() + copied, m.start - copied);
+            result += to_[m.pattern];
+            copied = m.end;
+        }
+        result.append(s.data() + copied, s.size() - copied);
+        return result;
+    }
+
+private:
+    static constexpr uint32_t FAIL = UINT32_MAX;
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Match {
+        size_t start;
+        size_t end;
+        uint32_t pattern;
+    };
+
+    void addState(uint32_t depth) {
+        delta_.resize(delta_.size() + classes_, FAIL);
+        depth_.push_back(depth);
+        fail_.push_back(0);
+        pattern_.push_back(NONE);
+        longest_.push_back(0);
+        longestPattern_.push_back(NONE);
+    }
+
+    // 按广度优先顺序求失败链接，并把缺失的转移补成完整的 DFA；
+    // longest_ 为状态串的后缀中最长的模式长度（0 表示没有）
+    void link() {
+        std::deque<uint32_t> queue;
+        for (uint32_t c = 0; c < classes_; c++) {
+            uint32_t& next = delta_[c];
+            if (next == FAIL) {
+                next = 0;
+            } else {
+                queue.push_back(next);
+            }
+        }
+        for (uint32_t c = 0; c < classes_; c++) {
+            uint32_t child = delta_[c];
+            if (child != 0) inherit(child);
+        }
+        while (!queue.empty()) {
+            uint32_t state = queue.front();
+            queue.pop_front();
+            const uint32_t* fallback = &delta_[fail_[state] * classes_];
+            uint32_t* row = &delta_[state * classes_];
+            for (uint32_t c = 0; c < classes_; c++) {
+                if (row[c] == FAIL) {
+                    row[c] = fallback[c];
+                } else {
+                    fail_[row[c]] = fallback[c];
+                    inherit(row[c]);
+                    queue.push_back(row[c]);
+                }
+            }
+        }
+    }
+
+    void inherit(uint32_t state) {
+        if (pattern_[state] != NONE) {
+            longest_[state] = depth_[state];
+            longestPattern_[state] = pattern_[state];
+        } else {
+            longest_[state] = longest_[fail_[state]];
+            longestPattern_[state] = longestPattern_[fail_[state]];
+        }
+    }
+
+    // 最左最长的不重叠匹配。自动机由反转的模式构成，从右往左扫描：停在位置 i 时，
+    // 状态对应 s[i..) 的最长的、同时是某个模式后缀的前缀，其中最长的模式（longest_）
+    // 正是从 i 开始的最长模式。之后从左往右贪心保留互不重叠的候选。
+    // 每个字节只经过一次转移，两遍都是线性的，与模式长度无关
+    std::vector<Match> matches(std::string_view s) const {
+        std::vector<Match> found;
+        if (to_.empty()) return found;
+        uint32_t state = 0;
+        for (size_t i = s.size(); i > 0;) {
+            if (state == 0) {
+                // 根状态下跳过不能结束任何模式的字节
+                while (i > 0 && !last_[static_cast<unsigned char>(s[i - 1])]) --i;
+                if (i == 0) break;
+            }
+            --i;
+            state = delta_[state * classes_ + class_[static_cast<unsigned char>(s[i])]];
+            if (longest_[state] != 0) found.push_back({i, i + longest_[state], longestPattern_[state]});
+        }
+        // 候选按起点从大到小收集；翻转后就地保留不与前一个匹配重叠的
+        std::reverse(found.begin(), found.end());
+        size_t kept = 0;
+        size_t pos = 0;
+        for (const Match& m : found) {
+            if (m.start < pos) continue;
+            found[kept++] = m;
+            pos = m.end;
+        }
+        found.resize(kept);
+        return found;
+    }
+
+    uint16_t class_[256];
+    bool last_[256];  // 能作为某个模式的末字节
+    uint32_t classes_ = 1;
+    std::vector<uint32_t> delta_;   // 状态数 × classes_
+    std::vector<uint32_t> depth_;
+    std::vector<uint32_t> fail_;
+    std::vector<uint32_t> pattern_;  // 以该状态结尾的模式（to_ 下标）
+    std::vector<uint32_t> longest_;
+    std::vector<uint32_t> longestPattern_;
+    std::vector<std::string> to_;
+};
+
+} // namespace str
+} // namespace ljos
+
+#endif // LJOS_STD_REPLACER_HPP
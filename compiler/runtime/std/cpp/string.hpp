@@ -6,135 +6,315 @@
 #ifndef LJOS_STD_STRING_HPP
 #define LJOS_STD_STRING_HPP
 
+#include <charconv>
+#include <climits>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
 #include <regex>
 
+#include "finder.hpp"
+#include "fmt.hpp"
+#include "replacer.hpp"
+
 namespace ljos {
 namespace str {
 
+// 只读参数统一用 std::string_view：std::string、字面量和视图都能直接传入而不复制。
+// 截取类函数（substring/slice/trim*/split）各有一个返回视图的 *View 版本，
+// 视图指向源字符串，源字符串释放或修改后失效；返回 std::string 的版本由它们构造。
+
 // ============ 基本操作 ============
 
 // 字符串长度
-inline size_t len(const std::string& s) {
+inline size_t len(std::string_view s) {
     return s.length();
 }
 
 // 是否为空
-inline bool isEmpty(const std::string& s) {
+inline bool isEmpty(std::string_view s) {
     return s.empty();
 }
 
 // 字符访问
-inline char charAt(const std::string& s, size_t index) {
+inline char charAt(std::string_view s, size_t index) {
     if (index >= s.length()) return '\0';
     return s[index];
 }
 
 // 子字符串
-inline std::string substring(const std::string& s, size_t start, size_t end = std::string::npos) {
-    if (start >= s.length()) return "";
+inline std::string_view substringView(std::string_view s, size_t start, size_t end = std::string::npos) {
+    if (start >= s.length()) return {};
     return s.substr(start, end - start);
 }
 
-inline std::string slice(const std::string& s, int start, int end = INT_MAX) {
+inline std::string substring(std::string_view s, size_t start, size_t end = std::string::npos) {
+    return std::string(substringView(s, start, end));
+}
+
+inline std::string_view sliceView(std::string_view s, int start, int end = INT_MAX) {
     int len = static_cast<int>(s.length());
     if (start < 0) start = std::max(0, len + start);
     if (end < 0) end = len + end;
-    if (start >= len || start >= end) return "";
+    if (start >= len || start >= end) return {};
     return s.substr(start, std::min(end, len) - start);
 }
 
+inline std::string slice(std::string_view s, int start, int end = INT_MAX) {
+    return std::string(sliceView(s, start, end));
+}
+
 // ============ 查找 ============
 
-inline size_t indexOf(const std::string& s, const std::string& search, size_t start = 0) {
-    size_t pos = s.find(search, start);
+// 子串查找都走 Finder（SIMD 过滤 / Two-Way），见 finder.hpp
+
+inline size_t indexOf(std::string_view s, std::string_view search, size_t start = 0) {
+    size_t pos = str::find(s, search, start);
     return pos == std::string::npos ? -1 : pos;
 }
 
-inline size_t lastIndexOf(const std::string& s, const std::string& search) {
+inline size_t lastIndexOf(std::string_view s, std::string_view search) {
     size_t pos = s.rfind(search);
     return pos == std::string::npos ? -1 : pos;
 }
 
-inline bool contains(const std::string& s, const std::string& search) {
-    return s.find(search) != std::string::npos;
+inline bool contains(std::string_view s, std::string_view search) {
+    return str::find(s, search) != std::string::npos;
 }
 
-inline bool startsWith(const std::string& s, const std::string& prefix) {
+inline bool startsWith(std::string_view s, std::string_view prefix) {
     if (prefix.length() > s.length()) return false;
     return s.compare(0, prefix.length(), prefix) == 0;
 }
 
-inline bool endsWith(const std::string& s, const std::string& suffix) {
+inline bool endsWith(std::string_view s, std::string_view suffix) {
     if (suffix.length() > s.length()) return false;
     return s.compare(s.length() - suffix.length(), suffix.length(), suffix) == 0;
 }
 
 // ============ 转换 ============
 
-inline std::string toUpper(const std::string& s) {
-    std::string result = s;
+inline std::string toUpper(std::string_view s) {
+    std::string result(s);
     std::transform(result.begin(), result.end(), result.begin(), ::toupper);
     return result;
 }
 
-inline std::string toLower(const std::string& s) {
-    std::string result = s;
+inline std::string toLower(std::string_view s) {
+    std::string result(s);
     std::transform(result.begin(), result.end(), result.begin(), ::tolower);
     return result;
 }
 
-inline std::string capitalize(const std::string& s) {
-    if (s.empty()) return s;
-    std::string result = s;
+inline std::string capitalize(std::string_view s) {
+    std::string result(s);
+    if (result.empty()) return result;
     result[0] = std::toupper(result[0]);
     return result;
 }
 
 // ============ 修剪 ============
 
-inline std::string trimLeft(const std::string& s) {
-    size_t start = s.find_first_not_of(" \t\n\r\f\v");
-    return start == std::string::npos ? "" : s.substr(start);
+constexpr std::string_view WHITESPACE = " \t\n\r\f\v";
+
+inline std::string_view trimLeftView(std::string_view s) {
+    size_t start = s.find_first_not_of(WHITESPACE);
+    return start == std::string_view::npos ? std::string_view() : s.substr(start);
+}
+
+inline std::string_view trimRightView(std::string_view s) {
+    size_t end = s.find_last_not_of(WHITESPACE);
+    return end == std::string_view::npos ? std::string_view() : s.substr(0, end + 1);
 }
 
-inline std::string trimRight(const std::string& s) {
-    size_t end = s.find_last_not_of(" \t\n\r\f\v");
-    return end == std::string::npos ? "" : s.substr(0, end + 1);
+inline std::string_view trimView(std::string_view s) {
+    return trimRightView(trimLeftView(s));
 }
 
-inline std::string trim(const std::string& s) {
-    return trimRight(trimLeft(s));
+inline std::string trimLeft(std::string_view s) {
+    return std::string(trimLeftView(s));
+}
+
+inline std::string trimRight(std::string_view s) {
+    return std::string(trimRightView(s));
+}
+
+// 两端都在视图上裁好，只分配一次
+inline std::string trim(std::string_view s) {
+    return std::string(trimView(s));
 }
 
 // ============ 分割和连接 ============
 
-inline std::vector<std::string> split(const std::string& s, const std::string& delimiter = " ") {
-    std::vector<std::string> result;
+inline std::vector<std::string_view> splitView(std::string_view s, std::string_view delimiter = " ") {
+    std::vector<std::string_view> result;
     if (delimiter.empty()) {
-        for (char c : s) {
-            result.push_back(std::string(1, c));
+        for (size_t i = 0; i < s.length(); i++) {
+            result.push_back(s.substr(i, 1));
         }
         return result;
     }
     
+    Finder finder{std::string(delimiter)};
     size_t start = 0;
-    size_t end = s.find(delimiter);
+    size_t end = finder.find(s);
     
-    while (end != std::string::npos) {
+    while (end != std::string_view::npos) {
         result.push_back(s.substr(start, end - start));
         start = end + delimiter.length();
-        end = s.find(delimiter, start);
+        end = finder.find(s, start);
     }
     
     result.push_back(s.substr(start));
     return result;
 }
 
+inline std::vector<std::string> split(std::string_view s, std::string_view delimiter = " ") {
+    std::vector<std::string_view> parts = splitView(s, delimiter);
+    return std::vector<std::string>(parts.begin(), parts.end());
+}
+
+// ============ 惰性分割 ============
+
+// split 的惰性版本：逐段产出指向源字符串的视图，不构建 vector，也不复制字段。
+// 既可以 for 遍历（前向迭代器，可重复遍历），也可以像 PrimeIterator 那样反复调用 next()。
+// 字段划分与 split 相同；视图在源字符串释放或修改后失效
+class SplitIterator {
+public:
+    explicit SplitIterator(std::string_view s, std::string_view delimiter = " ")
+        : source_(s), finder_(std::string(delimiter)) {}
+
+    // 下一个字段，没有更多时返回空
+    std::optional<std::string_view> next() const {
+        std::string_view field;
+        if (cursor_ == npos || !fieldAt(cursor_, field, cursor_)) {
+            cursor_ = npos;
+            return std::nullopt;
+        }
+        return field;
+    }
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        iterator() = default;
+        explicit iterator(const SplitIterator* owner) : owner_(owner) { seek(0); }
+
+        reference operator*() const { return field_; }
+        pointer operator->() const { return &field_; }
+
+        iterator& operator++() {
+            seek(next_);
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const iterator& other) const {
+            return owner_ == other.owner_ && field_.data() == other.field_.data();
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        void seek(size_t start) {
+            if (!owner_) return;
+            if (start == npos || !owner_->fieldAt(start, field_, next_)) {
+                owner_ = nullptr;
+                field_ = {};
+            }
+        }
+
+        const SplitIterator* owner_ = nullptr;
+        std::string_view field_;
+        size_t next_ = npos;
+    };
+
+    iterator begin() const { return iterator(this); }
+    iterator end() const { return iterator(); }
+
+private:
+    static constexpr size_t npos = std::string_view::npos;
+
+    // 从 start 开始的字段；next 为下一字段的起点，这是最后一段时为 npos
+    bool fieldAt(size_t start, std::string_view& field, size_t& next) const {
+        if (finder_.size() == 0) {
+            // 空分隔符逐字节分割，空串没有字段
+            if (start >= source_.size()) return false;
+            field = source_.substr(start, 1);
+            next = start + 1 < source_.size() ? start + 1 : npos;
+            return true;
+        }
+        size_t end = finder_.find(source_, start);
+        if (end == npos) {
+            field = source_.substr(start);
+            next = npos;
+        } else {
+            field = source_.substr(start, end - start);
+            next = end + finder_.size();
+        }
+        return true;
+    }
+
+    std::string_view source_;
+    Finder finder_;
+    mutable size_t cursor_ = 0;
+};
+
+inline SplitIterator splitIter(std::string_view s, std::string_view delimiter = " ") {
+    return SplitIterator(s, delimiter);
+}
+
+// 最多分成 n 段，最后一段保留剩余部分（不再分割）；n <= 0 时不限段数
+inline std::vector<std::string_view> splitNView(std::string_view s, std::string_view delimiter, int n) {
+    if (n <= 0) return splitView(s, delimiter);
+    std::vector<std::string_view> result;
+    SplitIterator parts(s, delimiter);
+    for (auto it = parts.begin(); it != parts.end(); ++it) {
+        if (static_cast<int>(result.size()) == n - 1) {
+            result.push_back(s.substr(it->data() - s.data()));
+            break;
+        }
+        result.push_back(*it);
+    }
+    return result;
+}
+
+inline std::vector<std::string> splitN(std::string_view s, std::string_view delimiter, int n) {
+    std::vector<std::string_view> parts = splitNView(s, delimiter, n);
+    return std::vector<std::string>(parts.begin(), parts.end());
+}
+
+// 第 n 个字段（从 0 开始），只扫描到该字段为止；字段不存在时为空
+inline std::string_view nthFieldView(std::string_view s, std::string_view delimiter, int n) {
+    if (n < 0) return {};
+    SplitIterator parts(s, delimiter);
+    for (std::string_view field : parts) {
+        if (n-- == 0) return field;
+    }
+    return {};
+}
+
+inline std::string nthField(std::string_view s, std::string_view delimiter, int n) {
+    return std::string(nthFieldView(s, delimiter, n));
+}
+
 inline std::string join(const std::vector<std::string>& parts, const std::string& delimiter = "") {
     if (parts.empty()) return "";
     
@@ -148,30 +328,51 @@ inline std::string join(const std::vector<std::string>& parts, const std::string
 
 // ============ 替换 ============
 
-inline std::string replace(const std::string& s, const std::string& from, const std::string& to) {
-    if (from.empty()) return s;
+// 先找出全部匹配位置，再按精确长度一次性拼出结果：O(n + 匹配数 × |to|)，
+// 不会像原地 result.replace 那样每次匹配都搬动后半段
+inline std::string replace(std::string_view s, std::string_view from, std::string_view to) {
+    if (from.empty()) return std::string(s);
     
-    std::string result = s;
-    size_t pos = 0;
-    while ((pos = result.find(from, pos)) != std::string::npos) {
-        result.replace(pos, from.length(), to);
-        pos += to.length();
+    Finder finder{std::string(from)};
+    std::vector<size_t> positions;
+    for (size_t pos = finder.find(s); pos != std::string_view::npos; pos = finder.find(s, pos + from.length())) {
+        positions.push_back(pos);
     }
+    if (positions.empty()) return std::string(s);
+    
+    std::string result;
+    result.reserve(s.length() - positions.size() * from.length() + positions.size() * to.length());
+    size_t copied = 0;
+    for (size_t pos : positions) {
+        result.append(s.data() + copied, pos - copied);
+        result += to;
+        copied = pos + from.length();
+    }
+    result.append(s.data() + copied, s.length() - copied);
     return result;
 }
 
-inline std::string replaceFirst(const std::string& s, const std::string& from, const std::string& to) {
-    size_t pos = s.find(from);
-    if (pos == std::string::npos) return s;
+inline std::string replaceFirst(std::string_view s, std::string_view from, std::string_view to) {
+    size_t pos = str::find(s, from);
+    if (pos == std::string_view::npos) return std::string(s);
     
-    std::string result = s;
-    result.replace(pos, from.length(), to);
+    std::string result;
+    result.reserve(s.length() - from.length() + to.length());
+    result.append(s.data(), pos);
+    result += to;
+    result.append(s.data() + pos + from.length(), s.length() - pos - from.length());
     return result;
 }
 
+// 一次替换多个模式（最左最长、互不重叠），见 replacer.hpp；
+// 同一组替换要用在很多字符串上时，直接构造一个 Replacer 重复使用
+inline std::string replaceMany(std::string_view s, const std::vector<std::pair<std::string, std::string>>& pairs) {
+    return Replacer(pairs).replace(s);
+}
+
 // ============ 重复和填充 ============
 
-inline std::string repeat(const std::string& s, int count) {
+inline std::string repeat(std::string_view s, int count) {
     if (count <= 0) return "";
     
     std::string result;
@@ -182,40 +383,102 @@ inline std::string repeat(const std::string& s, int count) {
     return result;
 }
 
-inline std::string padLeft(const std::string& s, size_t width, char fill = ' ') {
-    if (s.length() >= width) return s;
-    return std::string(width - s.length(), fill) + s;
+inline std::string padLeft(std::string_view s, size_t width, char fill = ' ') {
+    std::string result;
+    if (s.length() < width) result.assign(width - s.length(), fill);
+    result += s;
+    return result;
+}
+
+inline std::string padRight(std::string_view s, size_t width, char fill = ' ') {
+    std::string result(s);
+    if (s.length() < width) result.append(width - s.length(), fill);
+    return result;
+}
+
+namespace detail {
+
+// 用 pad 循环填满 count 个字节（最后一段截断），与 JS padStart/padEnd 一致
+inline void appendPadding(std::string& out, std::string_view pad, size_t count) {
+    if (pad.empty()) return;
+    for (; count >= pad.length(); count -= pad.length()) out += pad;
+    out += pad.substr(0, count);
 }
 
-inline std::string padRight(const std::string& s, size_t width, char fill = ' ') {
-    if (s.length() >= width) return s;
-    return s + std::string(width - s.length(), fill);
+} // namespace detail
+
+inline std::string padLeft(std::string_view s, size_t width, std::string_view pad) {
+    std::string result;
+    if (s.length() < width) detail::appendPadding(result, pad, width - s.length());
+    result += s;
+    return result;
+}
+
+inline std::string padRight(std::string_view s, size_t width, std::string_view pad) {
+    std::string result(s);
+    if (s.length() < width) detail::appendPadding(result, pad, width - s.length());
+    return result;
 }
 
 // ============ 类型转换 ============
 
-inline int toInt(const std::string& s, int defaultValue = 0) {
-    try {
-        return std::stoi(s);
-    } catch (...) {
-        return defaultValue;
+namespace detail {
+
+// 与 stoi/stod 一致：跳过前导空白，解析最长的数字前缀（"12px" 为 12），
+// 没有数字或超出范围时为空
+template <typename T>
+std::optional<T> parseNumber(std::string_view s, int radix = 10) {
+    static_assert(std::is_arithmetic_v<T>, "parseNumber expects a number type");
+    size_t skip = s.find_first_not_of(WHITESPACE);
+    if (skip == std::string_view::npos) return std::nullopt;
+    const char* first = s.data() + skip;
+    const char* last = s.data() + s.size();
+    if (*first == '+' && last - first > 1 && first[1] != '-') ++first;
+    T value{};
+    if constexpr (std::is_integral_v<T>) {
+        auto res = std::from_chars(first, last, value, radix);
+        if (res.ptr == first || res.ec != std::errc()) return std::nullopt;
+    } else {
+        (void)radix;
+#ifdef LJOS_FMT_FLOAT_TO_CHARS
+        auto res = std::from_chars(first, last, value);
+        if (res.ptr == first || res.ec != std::errc()) return std::nullopt;
+#else
+        std::string copy(first, last);
+        char* end = nullptr;
+        value = static_cast<T>(std::strtod(copy.c_str(), &end));
+        if (end == copy.c_str()) return std::nullopt;
+#endif
     }
+    return value;
 }
 
-inline double toFloat(const std::string& s, double defaultValue = 0.0) {
-    try {
-        return std::stod(s);
-    } catch (...) {
-        return defaultValue;
-    }
+} // namespace detail
+
+inline std::optional<int> parseInt(std::string_view s, int radix = 10) {
+    if (radix < 2 || radix > 36) return std::nullopt;
+    return detail::parseNumber<int>(s, radix);
+}
+
+inline std::optional<double> parseFloat(std::string_view s) {
+    return detail::parseNumber<double>(s);
+}
+
+inline int toInt(std::string_view s, int defaultValue = 0) {
+    return parseInt(s).value_or(defaultValue);
+}
+
+inline double toFloat(std::string_view s, double defaultValue = 0.0) {
+    return parseFloat(s).value_or(defaultValue);
 }
 
-inline std::string fromInt(int n) {
-    return std::to_string(n);
+inline std::string fromInt(long long n) {
+    return fmt::toString(n);
 }
 
+// 最短往返表示：fromFloat(2.5) 为 "2.5" 而不是 "2.500000"
 inline std::string fromFloat(double n) {
-    return std::to_string(n);
+    return fmt::toString(n);
 }
 
 // ============ 字符检查 ============
@@ -225,7 +488,7 @@ inline bool isAlpha(char c) { return std::isalpha(c); }
 inline bool isAlnum(char c) { return std::isalnum(c); }
 inline bool isSpace(char c) { return std::isspace(c); }
 
-inline bool isNumeric(const std::string& s) {
+inline bool isNumeric(std::string_view s) {
     if (s.empty()) return false;
     for (char c : s) {
         if (!std::isdigit(c) && c != '.' && c != '-' && c != '+') return false;
@@ -235,7 +498,7 @@ inline bool isNumeric(const std::string& s) {
 
 // ============ 反转 ============
 
-inline std::string reverse(const std::string& s) {
+inline std::string reverse(std::string_view s) {
     return std::string(s.rbegin(), s.rend());
 }
 
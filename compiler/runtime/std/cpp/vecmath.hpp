@@ -0,0 +1,410 @@
+/**
+ * Ljos Standard Library - Batch Math (C++ Runtime)
+ * 数组上的批量数学内核：sqrt / exp / log / sin / cos / pow / fma / dot / axpy。
+ * x86 上同时编译 AVX2 与 AVX-512 版本，首次调用时按 CPU 选择；其他平台只有标量实现。
+ * 环境变量 LJOS_SIMD=scalar|avx2|avx512 可以限制可用的最高指令集（用于对照测试）。
+ */
+
+#ifndef LJOS_STD_VECMATH_HPP
+#define LJOS_STD_VECMATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LJOS_VECMATH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ljos {
+namespace math {
+namespace batch {
+
+// ============ 内核常数 ============
+
+namespace kernel {
+
+constexpr double LOG2E = 1.4426950408889634;
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+constexpr double SQRT2 = 1.4142135623730951;
+
+constexpr double ROUND_MAGIC = 6755399441055744.0;  // 1.5 * 2^52
+constexpr double INT_MAGIC = 4503599627370496.0;    // 2^52
+constexpr double TWO_54 = 18014398509481984.0;
+constexpr double MIN_NORMAL = 2.2250738585072014e-308;
+constexpr int64_t MANTISSA_MASK = 0x000fffffffffffffLL;
+
+// e^r = Σ r^i / i!，|r| <= ln2/2 时截断误差约 4e-18
+constexpr double EXP_POLY[] = {
+    1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+    1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0,
+};
+constexpr size_t EXP_POLY_SIZE = sizeof(EXP_POLY) / sizeof(EXP_POLY[0]);
+constexpr double EXP_OVERFLOW = 709.782712893384;
+constexpr double EXP_UNDERFLOW = -745.1332191019412;
+
+// fdlibm e_log.c 的 Lg1..Lg7
+constexpr double LG[] = {
+    6.666666666666735130e-01, 3.999999999940941908e-01, 2.857142874366239149e-01,
+    2.222219843214978396e-01, 1.818357216161805012e-01, 1.531383769920937332e-01,
+    1.479819860511658591e-01,
+};
+
+// π/2 拆成三段各 33 位再加上剩余的尾数（fdlibm e_rem_pio2.c 的 pio2_1、pio2_2、pio2_3、pio2_3t）。
+// q < 2^20 时 q 与前三段的乘积都是精确的，余数很小时各步减法也是精确的，
+// 结果的误差来自最后一步；没有尾数那一段时，接近 π/2 整数倍的 x 误差可达 1e5 ulp
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+constexpr double PIO2_1 = 1.57079632673412561417e+00;
+constexpr double PIO2_2 = 6.07710050630396597660e-11;
+constexpr double PIO2_3 = 2.02226624871116645580e-21;
+constexpr double PIO2_3T = 8.47842766036889956997e-32;
+constexpr double REDUCE_LIMIT = 1e5;
+
+// fdlibm k_sin.c 的 S1..S6 与 k_cos.c 的 C1..C6
+constexpr double SIN_POLY[] = {
+    -1.66666666666666324348e-01, 8.33333333332248946124e-03, -1.98412698298579493134e-04,
+    2.75573137070700676789e-06, -2.50507602534068634195e-08, 1.58969099521155010221e-10,
+};
+constexpr double COS_POLY[] = {
+    4.16666666666666019037e-02, -1.38888888888741095749e-03, 2.48015872894767294178e-05,
+    -2.75573143513906633035e-07, 2.08757232129817482790e-09, -1.13596475577881948265e-11,
+};
+
+// pow 只对 0..POW_INT_MAX 的整数指数走向量平方乘，误差不超过 2 ulp
+constexpr double POW_INT_MAX = 4;
+
+} // namespace kernel
+
+// ============ 标量实现 ============
+
+namespace scalar {
+
+inline void sqrt(const double* in, double* out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::sqrt(in[i]); }
+inline void exp(const double* in, double* out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::exp(in[i]); }
+inline void log(const double* in, double* out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::log(in[i]); }
+inline void sin(const double* in, double* out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::sin(in[i]); }
+inline void cos(const double* in, double* out, size_t n) { for (size_t i = 0; i < n; i++) out[i] = std::cos(in[i]); }
+
+inline void powInt(const double* in, unsigned exponent, double* out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = std::pow(in[i], static_cast<double>(exponent));
+}
+
+inline void fma(const double* a, const double* b, const double* c, double* out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = std::fma(a[i], b[i], c[i]);
+}
+
+inline double dot(const double* a, const double* b, size_t n) {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+inline void axpy(double alpha, const double* x, double* y, size_t n) {
+    for (size_t i = 0; i < n; i++) y[i] += alpha * x[i];
+}
+
+} // namespace scalar
+
+#ifdef LJOS_VECMATH_X86
+
+// ============ AVX2 + FMA ============
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace avx2 {
+
+using V = __m256d;
+using Mask = __m256d;
+using I = __m256i;
+constexpr size_t LANES = 4;
+
+inline V load(const double* p) { return _mm256_loadu_pd(p); }
+inline void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+inline V set1(double x) { return _mm256_set1_pd(x); }
+
+inline V add(V a, V b) { return _mm256_add_pd(a, b); }
+inline V sub(V a, V b) { return _mm256_sub_pd(a, b); }
+inline V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+inline V div(V a, V b) { return _mm256_div_pd(a, b); }
+inline V fmadd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }    // a * b + c
+inline V fnmadd(V a, V b, V c) { return _mm256_fnmadd_pd(a, b, c); }  // c - a * b
+
+inline V sqrtv(V x) { return _mm256_sqrt_pd(x); }
+inline V roundv(V x) { return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline V absv(V x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+
+inline Mask lt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+inline Mask gt(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+inline Mask eq(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+inline Mask isnanv(V x) { return _mm256_cmp_pd(x, x, _CMP_UNORD_Q); }
+inline Mask orMask(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+inline V select(Mask m, V a, V b) { return _mm256_blendv_pd(b, a, m); }  // m ? a : b
+inline bool any(Mask m) { return _mm256_movemask_pd(m) != 0; }
+
+inline double hsum(V v) {
+    __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+inline I asInt(V v) { return _mm256_castpd_si256(v); }
+inline V asDouble(I v) { return _mm256_castsi256_pd(v); }
+inline I set1I(long long x) { return _mm256_set1_epi64x(x); }
+inline I addI(I a, I b) { return _mm256_add_epi64(a, b); }
+inline I subI(I a, I b) { return _mm256_sub_epi64(a, b); }
+inline I andI(I a, I b) { return _mm256_and_si256(a, b); }
+inline I orI(I a, I b) { return _mm256_or_si256(a, b); }
+inline I xorI(I a, I b) { return _mm256_xor_si256(a, b); }
+template <int N> inline I shlI(I a) { return _mm256_slli_epi64(a, N); }
+template <int N> inline I shrI(I a) { return _mm256_srli_epi64(a, N); }
+
+inline Mask nonzeroI(I a) {
+    I zero = _mm256_cmpeq_epi64(a, _mm256_setzero_si256());
+    return _mm256_castsi256_pd(_mm256_xor_si256(zero, _mm256_set1_epi64x(-1)));
+}
+
+#include "vecmath_kernels.inc"
+
+} // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+// ============ AVX-512F ============
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f,fma")
+#endif
+
+namespace avx512 {
+
+using V = __m512d;
+using Mask = __mmask8;
+using I = __m512i;
+constexpr size_t LANES = 8;
+
+inline V load(const double* p) { return _mm512_loadu_pd(p); }
+inline void store(double* p, V v) { _mm512_storeu_pd(p, v); }
+inline V set1(double x) { return _mm512_set1_pd(x); }
+
+inline V add(V a, V b) { return _mm512_add_pd(a, b); }
+inline V sub(V a, V b) { return _mm512_sub_pd(a, b); }
+inline V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+inline V div(V a, V b) { return _mm512_div_pd(a, b); }
+inline V fmadd(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+inline V fnmadd(V a, V b, V c) { return _mm512_fnmadd_pd(a, b, c); }
+
+// 全 1 掩码的 maskz 形式与普通指令相同，但避开 GCC 12 头文件里 _mm512_undefined_* 的 -Wuninitialized 误报
+constexpr __mmask8 ALL = 0xff;
+
+inline V sqrtv(V x) { return _mm512_maskz_sqrt_pd(ALL, x); }
+inline V roundv(V x) { return _mm512_maskz_roundscale_pd(ALL, x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline V absv(V x) { return _mm512_abs_pd(x); }
+
+inline Mask lt(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+inline Mask gt(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+inline Mask eq(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+inline Mask isnanv(V x) { return _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q); }
+inline Mask orMask(Mask a, Mask b) { return static_cast<Mask>(a | b); }
+inline V select(Mask m, V a, V b) { return _mm512_mask_blend_pd(m, b, a); }
+inline bool any(Mask m) { return m != 0; }
+inline double hsum(V v) {
+    __m256d half = _mm256_add_pd(_mm512_maskz_extractf64x4_pd(0xf, v, 0), _mm512_maskz_extractf64x4_pd(0xf, v, 1));
+    __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(half), _mm256_extractf128_pd(half, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+inline I asInt(V v) { return _mm512_castpd_si512(v); }
+inline V asDouble(I v) { return _mm512_castsi512_pd(v); }
+inline I set1I(long long x) { return _mm512_set1_epi64(x); }
+inline I addI(I a, I b) { return _mm512_add_epi64(a, b); }
+inline I subI(I a, I b) { return _mm512_sub_epi64(a, b); }
+inline I andI(I a, I b) { return _mm512_and_si512(a, b); }
+inline I orI(I a, I b) { return _mm512_or_si512(a, b); }
+inline I xorI(I a, I b) { return _mm512_xor_si512(a, b); }
+template <int N> inline I shlI(I a) { return _mm512_maskz_slli_epi64(ALL, a, N); }
+template <int N> inline I shrI(I a) { return _mm512_maskz_srli_epi64(ALL, a, N); }
+inline Mask nonzeroI(I a) { return _mm512_test_epi64_mask(a, a); }
+
+#include "vecmath_kernels.inc"
+
+} // namespace avx512
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // LJOS_VECMATH_X86
+
+// ============ 运行时分派 ============
+
+struct Kernels {
+    const char* isa;
+    void (*sqrt)(const double*, double*, size_t);
+    void (*exp)(const double*, double*, size_t);
+    void (*log)(const double*, double*, size_t);
+    void (*sin)(const double*, double*, size_t);
+    void (*cos)(const double*, double*, size_t);
+    void (*powInt)(const double*, unsigned, double*, size_t);
+    void (*fma)(const double*, const double*, const double*, double*, size_t);
+    double (*dot)(const double*, const double*, size_t);
+    void (*axpy)(double, const double*, double*, size_t);
+};
+
+namespace detail {
+
+#define LJOS_VECMATH_TABLE(ns) \
+    Kernels{#ns, ns::sqrt, ns::exp, ns::log, ns::sin, ns::cos, ns::powInt, ns::fma, ns::dot, ns::axpy}
+
+inline Kernels selectKernels() {
+    const char* cap = std::getenv("LJOS_SIMD");
+    bool scalarOnly = cap && std::strcmp(cap, "scalar") == 0;
+    bool noAvx512 = scalarOnly || (cap && std::strcmp(cap, "avx2") == 0);
+#ifdef LJOS_VECMATH_X86
+    __builtin_cpu_init();
+    if (!noAvx512 && __builtin_cpu_supports("avx512f")) return LJOS_VECMATH_TABLE(avx512);
+    if (!scalarOnly && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return LJOS_VECMATH_TABLE(avx2);
+#else
+    (void)noAvx512;
+#endif
+    return LJOS_VECMATH_TABLE(scalar);
+}
+
+#undef LJOS_VECMATH_TABLE
+
+} // namespace detail
+
+// 首次调用时检测一次
+inline const Kernels& kernels() {
+    static const Kernels table = detail::selectKernels();
+    return table;
+}
+
+// 当前使用的实现："scalar"、"avx2" 或 "avx512"
+inline const char* isa() { return kernels().isa; }
+
+// ============ 指针接口 ============
+
+// out 可以与 in 相同（原地计算）
+inline void sqrt(const double* in, double* out, size_t n) { kernels().sqrt(in, out, n); }
+inline void exp(const double* in, double* out, size_t n) { kernels().exp(in, out, n); }
+inline void log(const double* in, double* out, size_t n) { kernels().log(in, out, n); }
+inline void sin(const double* in, double* out, size_t n) { kernels().sin(in, out, n); }
+inline void cos(const double* in, double* out, size_t n) { kernels().cos(in, out, n); }
+
+inline void pow(const double* in, double exponent, double* out, size_t n) {
+    if (exponent >= 0 && exponent <= kernel::POW_INT_MAX && exponent == std::floor(exponent)) {
+        kernels().powInt(in, static_cast<unsigned>(exponent), out, n);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) out[i] = std::pow(in[i], exponent);
+}
+
+inline void fma(const double* a, const double* b, const double* c, double* out, size_t n) {
+    kernels().fma(a, b, c, out, n);
+}
+
+inline double dot(const double* a, const double* b, size_t n) { return kernels().dot(a, b, n); }
+
+inline void axpy(double alpha, const double* x, double* y, size_t n) { kernels().axpy(alpha, x, y, n); }
+
+// ============ 数组接口 ============
+
+namespace detail {
+
+using UnaryKernel = void (*)(const double*, double*, size_t);
+
+template <typename T>
+inline std::vector<double> apply(const std::vector<T>& in, UnaryKernel fn) {
+    static_assert(std::is_arithmetic_v<T>, "batch math expects a numeric array");
+    if constexpr (std::is_same_v<T, double>) {
+        std::vector<double> out(in.size());
+        fn(in.data(), out.data(), in.size());
+        return out;
+    } else {
+        std::vector<double> out(in.begin(), in.end());
+        fn(out.data(), out.data(), out.size());
+        return out;
+    }
+}
+
+// 临时数组直接原地计算
+inline std::vector<double> apply(std::vector<double>&& in, UnaryKernel fn) {
+    fn(in.data(), in.data(), in.size());
+    return std::move(in);
+}
+
+} // namespace detail
+
+// arr.map(math.sqrt) 等由代码生成器降为这里的调用
+template <typename Array>
+inline std::vector<double> sqrt(Array&& in) { return detail::apply(std::forward<Array>(in), kernels().sqrt); }
+template <typename Array>
+inline std::vector<double> exp(Array&& in) { return detail::apply(std::forward<Array>(in), kernels().exp); }
+template <typename Array>
+inline std::vector<double> log(Array&& in) { return detail::apply(std::forward<Array>(in), kernels().log); }
+template <typename Array>
+inline std::vector<double> sin(Array&& in) { return detail::apply(std::forward<Array>(in), kernels().sin); }
+template <typename Array>
+inline std::vector<double> cos(Array&& in) { return detail::apply(std::forward<Array>(in), kernels().cos); }
+
+template <typename T>
+inline std::vector<double> pow(const std::vector<T>& in, double exponent) {
+    std::vector<double> out(in.begin(), in.end());
+    pow(out.data(), exponent, out.data(), out.size());
+    return out;
+}
+
+} // namespace batch
+
+// ============ 向量运算 ============
+
+// 点积，长度不同时按较短的计算
+inline double dot(const std::vector<double>& a, const std::vector<double>& b) {
+    return batch::dot(a.data(), b.data(), std::min(a.size(), b.size()));
+}
+
+// 返回 y + alpha * x（y 按值传入，临时数组不再复制）
+inline std::vector<double> axpy(double alpha, const std::vector<double>& x, std::vector<double> y) {
+    batch::axpy(alpha, x.data(), y.data(), std::min(x.size(), y.size()));
+    return y;
+}
+
+// 逐元素 a * b + c，结果长度取三者最短
+inline std::vector<double> mulAdd(const std::vector<double>& a, const std::vector<double>& b,
+                                  const std::vector<double>& c) {
+    std::vector<double> out(std::min({a.size(), b.size(), c.size()}));
+    batch::fma(a.data(), b.data(), c.data(), out.data(), out.size());
+    return out;
+}
+
+} // namespace math
+} // namespace ljos
+
+#endif // LJOS_STD_VECMATH_HPP
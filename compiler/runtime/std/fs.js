@@ -68,6 +68,33 @@ export async function writeFileAsync(filePath, content) {
   }
 }
 
+export function readFileBytes(filePath) {
+  const fs = getFs();
+  if (!fs) return null;
+  try {
+    const buf = fs.readFileSync(filePath);
+    return new Uint8Array(buf.buffer, buf.byteOffset, buf.byteLength);
+  } catch (e) {
+    return null;
+  }
+}
+
+// JS 后端没有内存映射，与 readFileBytes 相同
+export function mapFileBytes(filePath) {
+  return readFileBytes(filePath);
+}
+
+export function writeFileBytes(filePath, content) {
+  const fs = getFs();
+  if (!fs) return false;
+  try {
+    fs.writeFileSync(filePath, content);
+    return true;
+  } catch (e) {
+    return false;
+  }
+}
+
 export function appendFile(filePath, content) {
   const fs = getFs();
   if (!fs) return false;
@@ -85,6 +112,219 @@ export function readLines(filePath) {
   return content.split('\n');
 }
 
+// 按行惰性遍历文件，分块读取，不一次性读入整个文件
+export function* lines(filePath) {
+  const fs = getFs();
+  if (!fs) return;
+  let fd;
+  try {
+    fd = fs.openSync(filePath, 'r');
+  } catch (e) {
+    return;
+  }
+  const chunk = Buffer.allocUnsafe(256 * 1024);
+  let pending = '';
+  try {
+    let n;
+    while ((n = fs.readSync(fd, chunk, 0, chunk.length, null)) > 0) {
+      const parts = (pending + chunk.toString('utf-8', 0, n)).split('\n');
+      pending = parts.pop();
+      yield* parts;
+    }
+    if (pending.length > 0) yield pending;
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+// ============ 缓冲写入句柄 ============
+
+export const SYNC_NONE = 0;
+export const SYNC_ON_CLOSE = 1;
+export const SYNC_GROUP = 2;
+
+// 保持文件打开的带缓冲写入器
+export class Writer {
+  constructor(fd, durability, bufferSize, intervalMs) {
+    this._fd = fd;
+    this._durability = durability;
+    this._bufferSize = bufferSize;
+    this._intervalMs = intervalMs;
+    this._parts = [];
+    this._buffered = 0;
+    this._lastSync = Date.now();
+    this._timer = null;
+  }
+
+  isOpen() {
+    return this._fd !== null;
+  }
+
+  write(content) {
+    if (this._fd === null) return false;
+    const str = String(content);
+    this._parts.push(str);
+    this._buffered += str.length;
+    if (this._buffered >= this._bufferSize && !this.flush()) return false;
+    if (this._durability === SYNC_GROUP && this._timer === null) {
+      // 由定时器在间隔到期时落盘，写完后不再写入的句柄也不会一直不同步
+      const delay = Math.max(0, this._lastSync + this._intervalMs - Date.now());
+      this._timer = setTimeout(() => {
+        this._timer = null;
+        if (this._fd !== null) this.sync();
+      }, delay);
+    }
+    return true;
+  }
+
+  writeLine(content) {
+    return this.write(String(content) + '\n');
+  }
+
+  flush() {
+    if (this._fd === null) return false;
+    if (this._parts.length === 0) return true;
+    const data = this._parts.join('');
+    this._parts = [];
+    this._buffered = 0;
+    try {
+      getFs().writeSync(this._fd, data, null, 'utf-8');
+      return true;
+    } catch (e) {
+      return false;
+    }
+  }
+
+  sync() {
+    if (!this.flush()) return false;
+    this._lastSync = Date.now();
+    try {
+      getFs().fdatasyncSync(this._fd);
+      return true;
+    } catch (e) {
+      return false;
+    }
+  }
+
+  close() {
+    if (this._fd === null) return false;
+    if (this._timer !== null) {
+      clearTimeout(this._timer);
+      this._timer = null;
+    }
+    const ok = this._durability === SYNC_NONE ? this.flush() : this.sync();
+    try {
+      getFs().closeSync(this._fd);
+    } catch (e) {
+      this._fd = null;
+      return false;
+    }
+    this._fd = null;
+    return ok;
+  }
+
+  dispose() {
+    this.close();
+  }
+}
+
+export function openWriter(filePath, append = false, durability = SYNC_NONE, bufferSize = 65536, intervalMs = 100) {
+  const fs = getFs();
+  let fd = null;
+  if (fs) {
+    try {
+      fd = fs.openSync(filePath, append ? 'a' : 'w');
+    } catch (e) {
+      fd = null;
+    }
+  }
+  return new Writer(fd, durability, bufferSize, intervalMs);
+}
+
+// ============ 原子写入 ============
+
+let tempCounter = 0;
+let groupCommitMs = 10;
+
+function writeTempAndRename(filePath, content, sync) {
+  const fs = getFs();
+  const path = getPath();
+  const tmp = `${filePath}.tmp.${process.pid}.${tempCounter++}`;
+  let fd = null;
+  try {
+    let mode = 0o644;
+    try {
+      mode = fs.statSync(filePath).mode & 0o7777;
+    } catch (e) {
+      // 目标不存在时使用默认权限
+    }
+    fd = fs.openSync(tmp, 'wx', mode);
+    fs.writeSync(fd, String(content), null, 'utf-8');
+    if (sync) fs.fdatasyncSync(fd);
+    fs.closeSync(fd);
+    fd = null;
+    fs.renameSync(tmp, filePath);
+    if (sync) {
+      const dirFd = fs.openSync(path.dirname(path.resolve(filePath)), 'r');
+      try {
+        fs.fsyncSync(dirFd);
+      } finally {
+        fs.closeSync(dirFd);
+      }
+    }
+    return true;
+  } catch (e) {
+    if (fd !== null) {
+      try { fs.closeSync(fd); } catch (e2) { /* ignore */ }
+    }
+    try { fs.unlinkSync(tmp); } catch (e2) { /* ignore */ }
+    return false;
+  }
+}
+
+// 组提交：同一间隔内的写入在一次定时回调中完成
+const groupQueue = [];
+
+// 同步写入前取消同一路径上仍在排队的组提交写入，避免它们稍后覆盖新内容；
+// 被取代的写入视为成功（效果等同于先写入再被覆盖）
+function supersedeGroup(filePath) {
+  for (let i = groupQueue.length - 1; i >= 0; i--) {
+    if (groupQueue[i].filePath === filePath) {
+      groupQueue[i].resolve(true);
+      groupQueue.splice(i, 1);
+    }
+  }
+}
+
+// 原子替换文件内容（临时文件 + rename）
+export function writeFileAtomic(filePath, content, durability = SYNC_ON_CLOSE) {
+  if (!getFs()) return false;
+  supersedeGroup(filePath);
+  return writeTempAndRename(filePath, content, durability !== SYNC_NONE);
+}
+
+function flushGroup() {
+  const batch = groupQueue.splice(0);
+  for (const item of batch) {
+    item.resolve(writeTempAndRename(item.filePath, item.content, true));
+  }
+}
+
+export function writeFileAtomicAsync(filePath, content, durability = SYNC_GROUP) {
+  if (!getFs()) return Promise.resolve(false);
+  if (durability !== SYNC_GROUP) {
+    return Promise.resolve(writeFileAtomic(filePath, content, durability));
+  }
+  return new Promise(resolve => {
+    groupQueue.push({ filePath, content, resolve });
+    if (groupQueue.length === 1) setTimeout(flushGroup, groupCommitMs);
+  });
+}
+
+export function setGroupCommitInterval(ms) {
+  groupCommitMs = ms > 0 ? ms : 0;
+}
+
 // ============ 文件信息 ============
 
 export function exists(filePath) {
@@ -117,12 +357,43 @@ export function fileSize(filePath) {
   const fs = getFs();
   if (!fs) return -1;
   try {
-    return fs.statSync(filePath).size;
+    const stats = fs.statSync(filePath);
+    return stats.isFile() ? stats.size : -1;
   } catch (e) {
     return -1;
   }
 }
 
+function toFileInfo(filePath, st) {
+  return {
+    path: filePath,
+    size: st.size,
+    isFile: st.isFile(),
+    isDir: st.isDirectory(),
+    isSymlink: st.isSymbolicLink(),
+    createdAt: Math.floor(st.birthtimeMs),
+    modifiedAt: Math.floor(st.mtimeMs),
+    accessedAt: Math.floor(st.atimeMs),
+    mode: st.mode & 0o7777,
+  };
+}
+
+// 一次 stat 取回全部元数据，失败返回 null
+export function stat(filePath, followSymlinks = true) {
+  const fs = getFs();
+  if (!fs) return null;
+  try {
+    const st = followSymlinks ? fs.statSync(filePath) : fs.lstatSync(filePath);
+    return toFileInfo(filePath, st);
+  } catch (e) {
+    return null;
+  }
+}
+
+export function statMany(paths, followSymlinks = true) {
+  return paths.map(p => stat(p, followSymlinks));
+}
+
 export function extension(filePath) {
   const path = getPath();
   if (!path) return '';
@@ -202,6 +473,51 @@ export function listDir(dirPath) {
   }
 }
 
+function globToRegExp(pattern) {
+  const escaped = pattern.replace(/[.+^${}()|[\]\\]/g, '\\$&');
+  return new RegExp('^' + escaped.replace(/\*/g, '.*').replace(/\?/g, '.') + '$');
+}
+
+// 递归遍历目录树，返回 { path, name, isFile, isDir, isSymlink, depth }
+export function walk(root, maxDepth = -1, include = [], exclude = []) {
+  const fs = getFs();
+  const path = getPath();
+  if (!fs) return [];
+  const includeRe = include.map(globToRegExp);
+  const excludeRe = exclude.map(globToRegExp);
+  const result = [];
+  const stack = [{ dir: root, depth: 0 }];
+  while (stack.length > 0) {
+    const { dir, depth } = stack.pop();
+    if (maxDepth >= 0 && depth >= maxDepth) continue;
+    let entries;
+    try {
+      entries = fs.readdirSync(dir, { withFileTypes: true });
+    } catch (e) {
+      continue;
+    }
+    const childDepth = depth + 1;
+    for (const entry of entries) {
+      if (excludeRe.some(re => re.test(entry.name))) continue;
+      const entryPath = path.join(dir, entry.name);
+      const isDir = entry.isDirectory();
+      if (isDir && (maxDepth < 0 || childDepth < maxDepth)) {
+        stack.push({ dir: entryPath, depth: childDepth });
+      }
+      if (includeRe.length > 0 && !includeRe.some(re => re.test(entry.name))) continue;
+      result.push({
+        path: entryPath,
+        name: entry.name,
+        isFile: entry.isFile(),
+        isDir,
+        isSymlink: entry.isSymbolicLink(),
+        depth: childDepth,
+      });
+    }
+  }
+  return result;
+}
+
 export function copy(src, dst) {
   const fs = getFs();
   if (!fs) return false;
@@ -213,6 +529,17 @@ export function copy(src, dst) {
   }
 }
 
+export function copyTree(src, dst) {
+  const fs = getFs();
+  if (!fs) return false;
+  try {
+    fs.cpSync(src, dst, { recursive: true, force: true, verbatimSymlinks: true });
+    return true;
+  } catch (e) {
+    return false;
+  }
+}
+
 export function move(src, dst) {
   const fs = getFs();
   if (!fs) return false;
@@ -224,6 +551,107 @@ export function move(src, dst) {
   }
 }
 
+// ============ 文件监视 ============
+
+export const WATCH_CREATE = 1;
+export const WATCH_MODIFY = 2;
+export const WATCH_REMOVE = 4;
+export const WATCH_RENAME = 8;
+export const WATCH_OVERFLOW = 16;
+
+// 基于 fs.watch 的监视器，coalesceMs 内的事件按路径合并后成批回调
+export class Watcher {
+  constructor(watcher, root) {
+    this._watcher = watcher;
+    this._root = root;
+    this._pending = new Map();
+    this._timer = null;
+    this._closed = false;
+    this._waiters = [];
+    this.callback = null;
+    this.coalesceMs = 50;
+  }
+
+  _add(filename, eventType) {
+    const fs = getFs();
+    const path = getPath();
+    const full = filename ? path.join(this._root, String(filename)) : this._root;
+    let kind = WATCH_MODIFY;
+    let isDir = false;
+    try {
+      isDir = fs.statSync(full).isDirectory();
+      if (eventType === 'rename') kind = WATCH_CREATE | WATCH_RENAME;
+    } catch (e) {
+      kind = WATCH_REMOVE | (eventType === 'rename' ? WATCH_RENAME : 0);
+    }
+    const prev = this._pending.get(full);
+    if (prev) {
+      prev.kind |= kind;
+      prev.isDir = prev.isDir || isDir;
+    } else {
+      this._pending.set(full, { path: full, kind, isDir });
+    }
+    if (this._timer === null) {
+      this._timer = setTimeout(() => this._deliver(), this.coalesceMs);
+    }
+  }
+
+  _deliver() {
+    this._timer = null;
+    const batch = Array.from(this._pending.values());
+    this._pending.clear();
+    if (batch.length > 0 && !this._closed && this.callback) this.callback(batch);
+  }
+
+  isOpen() {
+    return !this._closed;
+  }
+
+  // 监视结束时完成的 Promise
+  wait() {
+    if (this._closed) return Promise.resolve();
+    return new Promise(resolve => this._waiters.push(resolve));
+  }
+
+  close() {
+    if (this._closed) return;
+    // 已合并但未到交付时间的事件先交付
+    if (this._timer !== null) {
+      clearTimeout(this._timer);
+      this._deliver();
+    }
+    this._closed = true;
+    this._watcher.close();
+    for (const resolve of this._waiters) resolve();
+    this._waiters = [];
+  }
+
+  dispose() {
+    this.close();
+  }
+}
+
+// 监视文件或目录，返回 Watcher；失败时返回 null
+export function watch(filePath, callback, recursive = true, coalesceMs = 50) {
+  const fs = getFs();
+  if (!fs) return null;
+  try {
+    const isDir = fs.statSync(filePath).isDirectory();
+    let watcher = null;
+    const handle = fs.watch(filePath, { recursive: recursive && isDir }, (eventType, filename) => {
+      if (watcher) watcher._add(isDir ? filename : null, eventType);
+    });
+    watcher = new Watcher(handle, filePath);
+    // 底层监视出错即结束，isOpen() 随之返回 false
+    handle.on('error', () => watcher.close());
+    watcher.callback = callback;
+    watcher.coalesceMs = coalesceMs;
+    return watcher;
+  } catch (e) {
+    return null;
+  }
+}
+
 // ============ 路径操作 ============
 
 export function join(...parts) {
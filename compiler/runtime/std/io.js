@@ -21,6 +21,9 @@ export function printf(format, ...args) {
   print(formatString(format, ...args));
 }
 
+// 标准输出不经过额外缓冲，无需刷新
+export function flush() {}
+
 // ============ 标准输入 ============
 
 // Node.js 环境
@@ -0,0 +1,84 @@
+/**
+ * Ljos Standard Library - Log Module (JS Runtime)
+ * 日志的 JavaScript 实现：写入 stderr，格式与原生后端一致
+ */
+
+// ============ 级别 ============
+
+export const LEVEL_TRACE = 0;
+export const LEVEL_DEBUG = 1;
+export const LEVEL_INFO = 2;
+export const LEVEL_WARN = 3;
+export const LEVEL_ERROR = 4;
+export const LEVEL_OFF = 5;
+
+export const BLOCK = 0;
+export const DROP = 1;
+
+const LEVEL_NAMES = ['TRACE', 'DEBUG', 'INFO ', 'WARN ', 'ERROR'];
+
+let currentLevel = LEVEL_INFO;
+
+// ============ 配置 ============
+
+export function setLevel(level) {
+  currentLevel = level;
+}
+
+export function getLevel() {
+  return currentLevel;
+}
+
+// stderr 写入由运行时排队，不会丢弃
+export function setPolicy(policy) {}
+
+export function dropped() {
+  return 0;
+}
+
+export function flush() {}
+
+// stderr 写入本来就在调用时完成
+export function setSync(on) {}
+
+// ============ 输出 ============
+
+function pad(n, width) {
+  return String(n).padStart(width, '0');
+}
+
+function timestamp() {
+  const d = new Date();
+  return `${d.getFullYear()}-${pad(d.getMonth() + 1, 2)}-${pad(d.getDate(), 2)} ` +
+    `${pad(d.getHours(), 2)}:${pad(d.getMinutes(), 2)}:${pad(d.getSeconds(), 2)}.${pad(d.getMilliseconds(), 3)}`;
+}
+
+function write(level, args) {
+  if (level < currentLevel) return;
+  const line = `${timestamp()} ${LEVEL_NAMES[level] ?? '?????'} ${args.join('')}\n`;
+  if (typeof process !== 'undefined' && process.stderr) {
+    process.stderr.write(line);
+  } else {
+    console.error(line.trimEnd());
+  }
+}
+
+export function trace(...args) {
+  write(LEVEL_TRACE, args);
+}
+
+export function debug(...args) {
+  write(LEVEL_DEBUG, args);
+}
+
+export function info(...args) {
+  write(LEVEL_INFO, args);
+}
+
+export function warn(...args) {
+  write(LEVEL_WARN, args);
+}
+
+export function error(...args) {
+  write(LEVEL_ERROR, args);
+}
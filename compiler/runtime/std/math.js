@@ -198,16 +198,369 @@ export function isInfinite(x) {
 // Export with Ljos names
 export { isNaN_ as isNaN, isFinite_ as isFinite };
 
+// ============ 溢出控制的整数运算 ============
+// JS 的 Int 以安全整数范围 [MIN_INT, MAX_INT] 为界；回绕按 64 位补码
+
+function checkedResult(r) {
+  return Number.isSafeInteger(r) ? r : null;
+}
+
+export function addChecked(a, b) {
+  return checkedResult(a + b);
+}
+
+export function subChecked(a, b) {
+  return checkedResult(a - b);
+}
+
+export function mulChecked(a, b) {
+  return checkedResult(a * b);
+}
+
+export function divChecked(a, b) {
+  return b === 0 ? null : checkedResult(Math.trunc(a / b));
+}
+
+function wrap64(r) {
+  return Number(BigInt.asIntN(64, r));
+}
+
+export function addWrap(a, b) {
+  return wrap64(BigInt(a) + BigInt(b));
+}
+
+export function subWrap(a, b) {
+  return wrap64(BigInt(a) - BigInt(b));
+}
+
+export function mulWrap(a, b) {
+  return wrap64(BigInt(a) * BigInt(b));
+}
+
+function saturate(r) {
+  return Math.min(Math.max(r, MIN_INT), MAX_INT);
+}
+
+export function addSat(a, b) {
+  return saturate(a + b);
+}
+
+export function subSat(a, b) {
+  return saturate(a - b);
+}
+
+export function mulSat(a, b) {
+  return saturate(a * b);
+}
+
+// ============ 向量运算 ============
+
+export function dot(a, b) {
+  const n = Math.min(a.length, b.length);
+  let sum = 0;
+  for (let i = 0; i < n; i++) sum += a[i] * b[i];
+  return sum;
+}
+
+export function axpy(alpha, x, y) {
+  const out = y.slice();
+  const n = Math.min(x.length, y.length);
+  for (let i = 0; i < n; i++) out[i] += alpha * x[i];
+  return out;
+}
+
+export function mulAdd(a, b, c) {
+  const n = Math.min(a.length, b.length, c.length);
+  const out = new Array(n);
+  for (let i = 0; i < n; i++) out[i] = a[i] * b[i] + c[i];
+  return out;
+}
+
+// ============ 素数 ============
+
+const MR_BASES = [2n, 3n, 5n, 7n, 11n, 13n, 17n, 19n, 23n, 29n, 31n, 37n];
+
+function powModBig(base, exp, mod) {
+  let result = 1n;
+  base %= mod;
+  while (exp > 0n) {
+    if (exp & 1n) result = result * base % mod;
+    base = base * base % mod;
+    exp >>= 1n;
+  }
+  return result;
+}
+
+export function isPrime(n) {
+  if (!Number.isInteger(n) || n < 2) return false;
+  for (const p of [2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37]) {
+    if (n % p === 0) return n === p;
+  }
+  if (n < 41 * 41) return true;
+  if (n < 0x100000000) {
+    for (let i = 41; i * i <= n; i += 2) {
+      if (n % i === 0) return false;
+    }
+    return true;
+  }
+  // 这组底对 n < 3.3e24 是确定性的，覆盖全部安全整数
+  const big = BigInt(n);
+  let d = big - 1n;
+  let s = 0;
+  while ((d & 1n) === 0n) {
+    d >>= 1n;
+    s++;
+  }
+  outer: for (const a of MR_BASES) {
+    let x = powModBig(a, d, big);
+    if (x === 1n || x === big - 1n) continue;
+    for (let r = 1; r < s; r++) {
+      x = x * x % big;
+      if (x === big - 1n) continue outer;
+    }
+    return false;
+  }
+  return true;
+}
+
+export function nextPrime(n) {
+  if (n <= 2) return 2;
+  n = Math.ceil(n);
+  if (n % 2 === 0) n++;
+  while (!isPrime(n)) n += 2;
+  return n;
+}
+
+const SIEVE_SPAN = 1 << 18;
+
+// 分段筛 [lo, hi)，按升序产出
+function* sieveRange(lo, hi) {
+  lo = Math.max(lo, 0);
+  if (lo <= 2 && hi > 2) yield 2;
+  lo = Math.max(lo, 3) | 1;
+  if (lo >= hi) return;
+  const base = [];
+  const root = Math.floor(Math.sqrt(hi));
+  for (let p = 3; p <= root; p += 2) {
+    if (isPrime(p)) base.push(p);
+  }
+  for (let segLo = lo; segLo < hi; segLo += SIEVE_SPAN) {
+    const segHi = Math.min(hi, segLo + SIEVE_SPAN);
+    const composite = new Uint8Array((segHi - segLo + 1) >> 1);
+    for (const p of base) {
+      if (p * p >= segHi) break;
+      let first = Math.max(p * p, Math.ceil(segLo / p) * p);
+      if (first % 2 === 0) first += p;
+      for (let m = first; m < segHi; m += 2 * p) composite[(m - segLo) >> 1] = 1;
+    }
+    for (let i = 0; i < composite.length; i++) {
+      if (!composite[i]) yield segLo + 2 * i;
+    }
+  }
+}
+
+export function primesUpTo(limit, threads = 1) {
+  return Array.from(sieveRange(2, limit + 1));
+}
+
+export function primesInRange(lo, hi) {
+  return Array.from(sieveRange(lo, hi + 1));
+}
+
+export function countPrimes(limit, threads = 1) {
+  let count = 0;
+  for (const _ of sieveRange(2, limit + 1)) count++;
+  return count;
+}
+
+export class PrimeIterator {
+  constructor(from, to) {
+    this._cursor = from;
+    this._to = to;
+  }
+
+  next() {
+    if (this._cursor > this._to) return null;
+    const p = nextPrime(this._cursor);
+    if (p > this._to) {
+      this._cursor = this._to + 1;
+      return null;
+    }
+    this._cursor = p + 1;
+    return p;
+  }
+
+  *[Symbol.iterator]() {
+    for (let p = this.next(); p !== null; p = this.next()) yield p;
+  }
+}
+
+export function primes(from = 2, to = Number.MAX_SAFE_INTEGER) {
+  return new PrimeIterator(from, to);
+}
+
+// ============ 大整数 ============
+// 直接使用 JS 原生 BigInt
+
+export function bigInt(value) {
+  return BigInt(value);
+}
+
+export function parseBigInt(s) {
+  return /^[+-]?\d+$/.test(s) ? BigInt(s) : null;
+}
+
+export function bigPow(base, exp) {
+  return exp < 0 ? 0n : BigInt(base) ** BigInt(exp);
+}
+
+function productRange(lo, hi) {
+  if (lo > hi) return 1n;
+  if (hi - lo < 16) {
+    let result = 1n;
+    for (let i = lo; i <= hi; i++) result *= BigInt(i);
+    return result;
+  }
+  const mid = lo + Math.floor((hi - lo) / 2);
+  return productRange(lo, mid) * productRange(mid + 1, hi);
+}
+
+export function factorial(n) {
+  return n < 0 ? 0n : productRange(2, n);
+}
+
+export function fibonacci(n) {
+  if (n <= 0) return 0n;
+  let a = 0n;
+  let b = 1n;
+  for (let bit = 30; bit >= 0; bit--) {
+    const c = a * (2n * b - a);
+    const d = a * a + b * b;
+    if ((n >> bit) & 1) {
+      a = d;
+      b = c + d;
+    } else {
+      a = c;
+      b = d;
+    }
+  }
+  return a;
+}
+
 // ============ 随机数 ============
 
 export function random() {
-  return Math.random();
+  return nextRandom();
 }
 
 export function randomInt(min, max) {
-  return Math.floor(Math.random() * (max - min + 1)) + min;
+  return Math.floor(nextRandom() * (max - min + 1)) + min;
 }
 
 export function randomFloat(min, max) {
-  return Math.random() * (max - min) + min;
+  return nextRandom() * (max - min) + min;
+}
+
+// 与原生后端一致，seed 之后 random() 的序列可复现（JS 后端使用 xoshiro128++，数值与原生后端不同）
+let globalRng = null;
+
+export function seed(s) {
+  globalRng = newRng(s);
+}
+
+function nextRandom() {
+  return globalRng ? globalRng.random() : Math.random();
+}
+
+export function fillRandom(arr) {
+  for (let i = 0; i < arr.length; i++) arr[i] = nextRandom();
+}
+
+export function fillRandomInt(arr, min, max) {
+  for (let i = 0; i < arr.length; i++) arr[i] = Math.floor(nextRandom() * (max - min + 1)) + min;
+}
+
+// ============ Rng - 独立的随机数流 ============
+
+function rotl32(x, k) {
+  return (x << k) | (x >>> (32 - k));
+}
+
+const RNG_JUMP = [0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b];
+
+export class Rng {
+  constructor(state) {
+    this.s = Uint32Array.from(state);
+  }
+
+  static fromSeed(seed) {
+    // splitmix32 展开种子
+    let x = seed >>> 0;
+    const state = [];
+    for (let i = 0; i < 4; i++) {
+      x = (x + 0x9e3779b9) >>> 0;
+      let z = x;
+      z = Math.imul(z ^ (z >>> 16), 0x85ebca6b);
+      z = Math.imul(z ^ (z >>> 13), 0xc2b2ae35);
+      state.push((z ^ (z >>> 16)) >>> 0);
+    }
+    return new Rng(state);
+  }
+
+  next() {
+    const s = this.s;
+    const result = (rotl32((s[0] + s[3]) | 0, 7) + s[0]) >>> 0;
+    const t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl32(s[3], 11);
+    return result;
+  }
+
+  random() {
+    return ((this.next() >>> 5) * 67108864 + (this.next() >>> 6)) / 9007199254740992;
+  }
+
+  randomInt(min, max) {
+    return Math.floor(this.random() * (max - min + 1)) + min;
+  }
+
+  randomFloat(min, max) {
+    return this.random() * (max - min) + min;
+  }
+
+  fill(arr) {
+    for (let i = 0; i < arr.length; i++) arr[i] = this.random();
+  }
+
+  fillInt(arr, min, max) {
+    for (let i = 0; i < arr.length; i++) arr[i] = this.randomInt(min, max);
+  }
+
+  // 跳过 2^64 个数
+  jump() {
+    const t = new Uint32Array(4);
+    for (const word of RNG_JUMP) {
+      for (let b = 0; b < 32; b++) {
+        if (word & (1 << b)) {
+          for (let i = 0; i < 4; i++) t[i] ^= this.s[i];
+        }
+        this.next();
+      }
+    }
+    this.s.set(t);
+  }
+
+  split() {
+    const child = new Rng(this.s);
+    this.jump();
+    return child;
+  }
+}
+
+export function newRng(seed) {
+  return Rng.fromSeed(seed);
 }
@@ -71,6 +71,53 @@ export function split(s, delimiter) {
   return s.split(delimiter);
 }
 
+export function splitN(s, delimiter, n) {
+  const parts = s.split(delimiter);
+  if (n <= 0 || parts.length <= n) return parts;
+  return [...parts.slice(0, n - 1), parts.slice(n - 1).join(delimiter)];
+}
+
+export function nthField(s, delimiter, n) {
+  if (n < 0) return "";
+  for (const field of splitIter(s, delimiter)) {
+    if (n-- === 0) return field;
+  }
+  return "";
+}
+
+export class SplitIterator {
+  constructor(s, delimiter) {
+    this._s = s;
+    this._delimiter = delimiter;
+    // 下一字段的起点，没有更多时为 -1
+    this._cursor = delimiter === "" && s === "" ? -1 : 0;
+  }
+
+  next() {
+    if (this._cursor < 0) return null;
+    const start = this._cursor;
+    if (this._delimiter === "") {
+      this._cursor = start + 1 < this._s.length ? start + 1 : -1;
+      return this._s[start];
+    }
+    const end = this._s.indexOf(this._delimiter, start);
+    if (end < 0) {
+      this._cursor = -1;
+      return this._s.slice(start);
+    }
+    this._cursor = end + this._delimiter.length;
+    return this._s.slice(start, end);
+  }
+
+  *[Symbol.iterator]() {
+    for (let f = this.next(); f !== null; f = this.next()) yield f;
+  }
+}
+
+export function splitIter(s, delimiter) {
+  return new SplitIterator(s, delimiter);
+}
+
 export function join(parts, separator = "") {
   return parts.join(separator);
 }
@@ -83,6 +130,30 @@ export function replaceAll(s, old, newStr) {
   return s.replaceAll(old, newStr);
 }
 
+// 多模式替换：最左最长、互不重叠。模式按长度降序拼成一个正则交替式，
+// 正则引擎在每个位置按顺序尝试，于是同一位置取到最长的模式
+export class Replacer {
+  constructor(pairs) {
+    const entries = pairs instanceof Map ? [...pairs] : Array.isArray(pairs) ? pairs : Object.entries(pairs);
+    this._to = new Map();
+    for (const [from, to] of entries) {
+      if (from !== "" && !this._to.has(from)) this._to.set(from, to);
+    }
+    const patterns = [...this._to.keys()]
+      .sort((a, b) => b.length - a.length)
+      .map(p => p.replace(/[.*+?^${}()|[\]\\]/g, '\\$&'));
+    this._regex = patterns.length > 0 ? new RegExp(patterns.join('|'), 'g') : null;
+  }
+
+  replace(s) {
+    return this._regex ? s.replace(this._regex, m => this._to.get(m)) : s;
+  }
+}
+
+export function replaceMany(s, pairs) {
+  return new Replacer(pairs).replace(s);
+}
+
 export function repeat(s, count) {
   return s.repeat(count);
 }
@@ -15,12 +15,277 @@ export interface CppGenerateResult {
   hpp?: string; // Header file content (for non-entry files)
 }
 
+// Errors detected while lowering (e.g. printf argument mismatches)
+export class CodegenError extends Error {
+  constructor(message: string, public line: number = 0, public column: number = 0) {
+    super(`Codegen Error at ${line}:${column}: ${message}`);
+    this.name = 'CodegenError';
+  }
+}
+
 // Type information for variables
 interface VarInfo {
   cppType: string;
   isConst: boolean;
 }
 
+// A std library function bound to the native C++ runtime
+interface StdSymbol {
+  module: string; // e.g. 'fs' for /std/fs
+  name: string;   // exported name inside the module
+}
+
+// Std modules backed by the header-only runtime in runtime/std/cpp
+// (copied next to the generated sources, found through -I <rootDir>)
+const STD_RUNTIME_HEADERS: Record<string, string> = {
+  fs: 'runtime/std/cpp/fs.hpp',
+  io: 'runtime/std/cpp/io.hpp',
+  log: 'runtime/std/cpp/log.hpp',
+  math: 'runtime/std/cpp/math.hpp',
+  string: 'runtime/std/cpp/string.hpp',
+};
+
+// C++ namespaces of std modules whose runtime namespace differs from the module name
+const STD_NAMESPACES: Record<string, string> = {
+  string: 'str',
+};
+
+// Core Bytes type (ljos::Bytes), also pulled in by fs.hpp
+const BYTES_RUNTIME_HEADER = 'runtime/std/cpp/bytes.hpp';
+
+// Number formatting core (ljos::fmt), used for template strings and string concatenation
+const FMT_RUNTIME_HEADER = 'runtime/std/cpp/fmt.hpp';
+
+// fs queries answerable from a single ljos::fs::stat() result
+const FS_METADATA_QUERIES = new Set(['exists', 'isFile', 'isDir', 'fileSize', 'stat']);
+
+// fs functions that only read paths or metadata (safe between merged stat queries)
+const FS_READONLY_FUNCTIONS = new Set([
+  ...FS_METADATA_QUERIES, 'readFile', 'readFileAsync', 'readFileBytes', 'mapFileBytes', 'readLines', 'lines', 'walk', 'statMany',
+  'extension', 'filename', 'parent', 'join', 'absolute', 'cwd',
+  'basename', 'dirname', 'extname', 'resolve', 'relative', 'normalize', 'isAbsolute',
+]);
+
+// std modules whose calls are pure and quick, so merged stat queries may span them.
+// Anything else (stdin, sleeps, processes, user functions) gives other processes
+// time to change the file between the stat and the query it answers.
+const FS_SAFE_MODULES = new Set(['math', 'string']);
+
+// std/fs.lj names that differ from the ljos::fs runtime names
+const STD_FS_ALIASES: Record<string, string> = {
+  mkdirAll: 'mkdirp',
+  rmdir: 'remove',
+  rmdirAll: 'removeAll',
+  rename: 'move',
+  basename: 'filename',
+  dirname: 'parent',
+  extname: 'extension',
+  resolve: 'absolute',
+  readDir: 'listDir',
+};
+
+// std/io.lj names that differ from the ljos::io runtime names
+const STD_IO_ALIASES: Record<string, string> = {
+  printf: 'printf_fmt',
+};
+
+// std/math.lj names that clash with <cmath> macros
+const STD_MATH_ALIASES: Record<string, string> = {
+  INFINITY: 'INF',
+  NEG_INFINITY: 'NEG_INF',
+  NAN: 'NOT_A_NUMBER',
+};
+
+// std/string.lj names that differ from the ljos::str runtime names
+// (replace is first-match only, as in JS; replaceAll replaces every match)
+const STD_STRING_ALIASES: Record<string, string> = {
+  toUpperCase: 'toUpper',
+  toLowerCase: 'toLower',
+  trimStart: 'trimLeft',
+  trimEnd: 'trimRight',
+  replace: 'replaceFirst',
+  replaceAll: 'replace',
+  padStart: 'padLeft',
+  padEnd: 'padRight',
+};
+
+// Runtime-specific name tables per std module
+const STD_ALIASES: Record<string, Record<string, string>> = {
+  fs: STD_FS_ALIASES,
+  io: STD_IO_ALIASES,
+  math: STD_MATH_ALIASES,
+  string: STD_STRING_ALIASES,
+};
+
+// string functions with a *View variant (trim -> ljos::str::trimView) returning a
+// std::string_view into their first argument instead of a fresh std::string
+const STRING_VIEW_FUNCTIONS = new Set(['substring', 'slice', 'trim', 'trimStart', 'trimEnd', 'nthField', 'split', 'splitN']);
+
+// View functions returning a vector of views rather than a single view
+const STRING_SPLIT_FUNCTIONS = new Set(['split', 'splitN']);
+
+// string functions that take their string arguments as std::string_view
+// (std/string.lj names plus runtime-only ones reachable through `string.<name>`)
+const STRING_VIEW_PARAMS = new Set([
+  ...STRING_VIEW_FUNCTIONS, 'len', 'isEmpty', 'charAt', 'indexOf', 'lastIndexOf', 'contains',
+  'startsWith', 'endsWith', 'toUpperCase', 'toLowerCase', 'repeat', 'padStart', 'padEnd', 'reverse',
+  'parseInt', 'parseFloat', 'toUpper', 'toLower', 'capitalize', 'trimLeft', 'trimRight',
+  'padLeft', 'padRight', 'toInt', 'toFloat', 'isNumeric', 'splitIter',
+  'replace', 'replaceAll', 'replaceFirst', 'replaceMany',
+]);
+
+const COMPARISON_OPERATORS = new Set(['==', '!=', '<', '<=', '>', '>=']);
+
+// math functions with an array kernel in ljos::math::batch; arr.map(sqrt) and
+// arr.map((x) => sqrt(x)) are lowered to one batch call instead of a per-element loop
+const MATH_BATCH_FUNCTIONS = new Set(['sqrt', 'exp', 'log', 'sin', 'cos']);
+
+// Compile-time value of a math expression, tagged with the C++ type the runtime call returns
+type NumericConstant = { kind: 'int' | 'long long' | 'double'; value: number };
+type MathConstant = NumericConstant | { kind: 'bool'; value: boolean } | { kind: 'BigInt'; value: bigint };
+
+const CONSTANT_CPP_TYPES: Record<MathConstant['kind'], string> = {
+  'int': 'int',
+  'long long': 'long long',
+  'double': 'double',
+  'bool': 'bool',
+  'BigInt': 'ljos::math::BigInt',
+};
+
+// ljos::math constants (the C++ literals round to the same doubles)
+const MATH_CONSTANT_VALUES: Record<string, number> = {
+  PI: Math.PI,
+  E: Math.E,
+  TAU: 2 * Math.PI,
+  SQRT2: Math.SQRT2,
+  SQRT1_2: Math.SQRT1_2,
+  LN2: Math.LN2,
+  LN10: Math.LN10,
+  LOG2E: Math.LOG2E,
+  LOG10E: Math.LOG10E,
+};
+
+const INT32_MIN = -(2 ** 31);
+const INT32_MAX = 2 ** 31 - 1;
+const INT64_MAX = (1n << 63n) - 1n;
+
+const isIntConstant = (c: NumericConstant) => c.kind !== 'double' && Number.isSafeInteger(c.value);
+const isInt32 = (c: NumericConstant) => isIntConstant(c) && c.value >= INT32_MIN && c.value <= INT32_MAX;
+
+// INT32_MIN has no plain C++ literal; leave those calls to the runtime
+const intConstant = (value: number): MathConstant | null =>
+  value > INT32_MIN && value <= INT32_MAX ? { kind: 'int', value } : null;
+const doubleConstant = (value: number): MathConstant | null =>
+  Number.isFinite(value) ? { kind: 'double', value } : null;
+const bigIntConstant = (value: bigint): MathConstant | null =>
+  value <= INT64_MAX ? { kind: 'BigInt', value } : null;
+
+// The winner of min/max converted to std::common_type_t<A, B>
+function commonTypeConstant(a: NumericConstant, b: NumericConstant, winner: NumericConstant): MathConstant | null {
+  if ((a.kind !== 'double' && !isIntConstant(a)) || (b.kind !== 'double' && !isIntConstant(b))) return null;
+  const kind = a.kind === 'double' || b.kind === 'double' ? 'double' : a.kind === 'long long' || b.kind === 'long long' ? 'long long' : 'int';
+  if (kind === 'int') return intConstant(winner.value);
+  return kind === 'double' ? doubleConstant(winner.value) : { kind, value: winner.value };
+}
+
+function gcdConstant(a: number, b: number): number {
+  a = Math.abs(a);
+  b = Math.abs(b);
+  while (b !== 0) [a, b] = [b, a % b];
+  return a;
+}
+
+// Deterministic Miller-Rabin for n < 2^53 (these bases cover n < 3.3e24)
+function isPrimeConstant(value: number): boolean {
+  if (value < 2) return false;
+  const n = BigInt(value);
+  for (const p of [2n, 3n, 5n, 7n, 11n, 13n, 17n, 19n, 23n, 29n, 31n, 37n]) {
+    if (n % p === 0n) return n === p;
+  }
+  let d = n - 1n;
+  let s = 0;
+  while (d % 2n === 0n) {
+    d /= 2n;
+    s++;
+  }
+  const powMod = (base: bigint, exp: bigint): bigint => {
+    let result = 1n;
+    for (base %= n; exp > 0n; exp >>= 1n) {
+      if (exp & 1n) result = result * base % n;
+      base = base * base % n;
+    }
+    return result;
+  };
+  return [2n, 3n, 5n, 7n, 11n, 13n, 17n, 19n, 23n, 29n, 31n, 37n].every(a => {
+    let x = powMod(a, d);
+    if (x === 1n || x === n - 1n) return true;
+    for (let r = 1; r < s; r++) {
+      x = x * x % n;
+      if (x === n - 1n) return true;
+    }
+    return false;
+  });
+}
+
+// Pure ljos::math functions folded to a literal when every argument is a compile-time
+// constant. Each folder mirrors the runtime overload C++ would pick and returns null
+// when the result could differ (overflow, NaN, ambiguous overload), leaving the call.
+const MATH_FOLDERS: Record<string, { arity: number; fold: (args: NumericConstant[]) => MathConstant | null }> = {
+  // abs/min/max are templates returning std::common_type of their arguments (int <
+  // long long < double); abs of INT32_MIN does not fit an int, so that call is left alone
+  abs: { arity: 1, fold: ([x]) => {
+    if (x.kind === 'double') return doubleConstant(Math.abs(x.value));
+    if (!isIntConstant(x)) return null;
+    return x.kind === 'int' ? intConstant(Math.abs(x.value)) : { kind: 'long long', value: Math.abs(x.value) };
+  } },
+  // std::min / std::max semantics: the first argument wins ties (matters for -0.0)
+  min: { arity: 2, fold: ([a, b]) => commonTypeConstant(a, b, b.value < a.value ? b : a) },
+  max: { arity: 2, fold: ([a, b]) => commonTypeConstant(a, b, a.value < b.value ? b : a) },
+  sign: { arity: 1, fold: ([x]) => intConstant(x.value > 0 ? 1 : x.value < 0 ? -1 : 0) },
+  sqrt: { arity: 1, fold: ([x]) => doubleConstant(Math.sqrt(x.value)) },
+  toRadians: { arity: 1, fold: ([x]) => doubleConstant(x.value * Math.PI / 180) },
+  toDegrees: { arity: 1, fold: ([x]) => doubleConstant(x.value * 180 / Math.PI) },
+  gcd: { arity: 2, fold: ([a, b]) => isInt32(a) && isInt32(b) ? intConstant(gcdConstant(a.value, b.value)) : null },
+  lcm: { arity: 2, fold: ([a, b]) => {
+    if (!isInt32(a) || !isInt32(b)) return null;
+    if (a.value === 0 || b.value === 0) return intConstant(0);
+    return intConstant(Math.abs(a.value / gcdConstant(a.value, b.value) * b.value));
+  } },
+  isPrime: { arity: 1, fold: ([n]) => isIntConstant(n) ? { kind: 'bool', value: isPrimeConstant(n.value) } : null },
+  // Past 2^53 p++ stops changing p; leave those calls to the runtime
+  nextPrime: { arity: 1, fold: ([n]) => {
+    if (!isIntConstant(n)) return null;
+    let p = Math.max(n.value, 2);
+    while (!isPrimeConstant(p)) {
+      if (++p > Number.MAX_SAFE_INTEGER) return null;
+    }
+    return { kind: 'long long', value: p };
+  } },
+  factorial: { arity: 1, fold: ([n]) => {
+    if (!isInt32(n)) return null;
+    let result = n.value < 0 ? 0n : 1n;
+    for (let i = 2; i <= n.value && result <= INT64_MAX; i++) result *= BigInt(i);
+    return bigIntConstant(result);
+  } },
+  fibonacci: { arity: 1, fold: ([n]) => {
+    if (!isInt32(n)) return null;
+    let [a, b] = [0n, 1n];
+    for (let i = 0; i < n.value && a <= INT64_MAX; i++) [a, b] = [b, a + b];
+    return bigIntConstant(a);
+  } },
+};
+
+// io functions taking a Ljos format string (%s %d %i %f %o %b %%); a literal
+// format is parsed at compile time via LJOS_FORMAT
+const IO_FORMAT_FUNCTIONS = new Set(['printf', 'format']);
+const FORMAT_PLACEHOLDER = /%[sdifob%]/g;
+
+// io functions also recognised by name when /std/io was not imported explicitly
+const IO_BUILTINS = new Set(['println', 'print', 'readln', 'readInt', 'readFloat', 'eprintln', 'eprint', 'dbg']);
+
+// io functions that write their arguments out without keeping them
+const IO_PRINT_FUNCTIONS = new Set(['println', 'print', 'eprintln', 'eprint']);
+
 export class CppCodeGenerator {
   private indent = 0;
   private isEntryPoint: boolean;
@@ -43,6 +308,17 @@ export class CppCodeGenerator {
   // Variable type tracking
   private varTypes: Map<string, VarInfo> = new Map();
   
+  // Std library imports resolved to the native runtime
+  private stdImports: Map<string, StdSymbol> = new Map();
+  private stdNamespaces: Map<string, string> = new Map();
+  
+  // Statements of the function (or top-level program) being generated, for usage analysis
+  private currentBody: AST.Statement[] = [];
+  
+  // Path key -> temp holding a merged ljos::fs::stat() result for the current statement run
+  private statCache: Map<string, string> = new Map();
+  private tempCounter = 0;
+  
   // Current context
   private inClass = false;
   private currentClassName = '';
@@ -61,6 +337,11 @@ export class CppCodeGenerator {
     this.mainCode = [];
     this.classes = new Map();
     this.varTypes = new Map();
+    this.stdImports = new Map();
+    this.stdNamespaces = new Map();
+    this.currentBody = program.body;
+    this.statCache = new Map();
+    this.tempCounter = 0;
     this.indent = 0;
 
     // Add standard includes
@@ -176,14 +457,21 @@ export class CppCodeGenerator {
     
     // Map standard library imports to C++ equivalents
     if (source === '/std/io' || source.endsWith('/std/io')) {
-      // println/print -> cout
-      this.includes.add('#include <iostream>');
+      // println/print -> ljos::io::Out (buffered stdout)
+      this.includes.add(`#include "${STD_RUNTIME_HEADERS.io}"`);
     } else if (source === '/std/core' || source.endsWith('/std/core')) {
       // Core types are built-in
     } else if (source === '/std/math' || source.endsWith('/std/math')) {
-      this.includes.add('#include <cmath>');
+      // Scalar functions plus SIMD batch kernels (ljos::math::batch)
+      this.includes.add(`#include "${STD_RUNTIME_HEADERS.math}"`);
     } else if (source === '/std/fs' || source.endsWith('/std/fs')) {
-      this.includes.add('#include <fstream>');
+      this.includes.add(`#include "${STD_RUNTIME_HEADERS.fs}"`);
+    } else if (source === '/std/log' || source.endsWith('/std/log')) {
+      // Asynchronous logger (per-thread rings drained by a background thread)
+      this.includes.add(`#include "${STD_RUNTIME_HEADERS.log}"`);
+    } else if (source === '/std/string' || source.endsWith('/std/string')) {
+      // ljos::str, with std::string_view variants for slicing and trimming
+      this.includes.add(`#include "${STD_RUNTIME_HEADERS.string}"`);
     } else if (source.startsWith('./') || source.startsWith('../')) {
       // Local module import - generate include for the header
       // Convert ./utils/greeting to utils/greeting.hpp
@@ -191,6 +479,19 @@ export class CppCodeGenerator {
       this.includes.add(`#include "${headerPath}"`);
     }
     
+    // Runtime-backed std modules: calls are lowered to ljos::<module>::* directly
+    const stdModule = this.stdModuleName(source);
+    if (stdModule && STD_RUNTIME_HEADERS[stdModule]) {
+      for (const spec of stmt.specifiers) {
+        if (spec.type === 'named') {
+          this.stdImports.set(spec.local, { module: stdModule, name: spec.imported });
+        } else {
+          this.stdNamespaces.set(spec.local, stdModule);
+        }
+      }
+      return;
+    }
+    
     // For local imports, add forward declarations for imported symbols
     for (const spec of stmt.specifiers) {
       if (spec.type === 'named' || spec.type === 'default') {
@@ -207,6 +508,484 @@ export class CppCodeGenerator {
     }
   }
 
+  private stdModuleName(source: string): string | null {
+    const match = /(?:^|\/)std\/([A-Za-z_]+)$/.exec(source);
+    return match ? match[1] : null;
+  }
+
+  // Resolve a callee to a runtime-backed std function (`readFile` or `fs.readFile`)
+  private resolveStdCallee(callee: AST.Expression): StdSymbol | null {
+    if (callee.type === 'Identifier') {
+      return this.stdImports.get(callee.name) ?? null;
+    }
+    if (callee.type === 'MemberExpression' && !callee.computed &&
+        callee.object.type === 'Identifier' && callee.property.type === 'Identifier') {
+      const module = this.stdNamespaces.get(callee.object.name);
+      if (module) return { module, name: callee.property.name };
+    }
+    return null;
+  }
+
+  private isStdCall(expr: AST.Expression, module: string, name: string): expr is AST.CallExpression {
+    if (expr.type !== 'CallExpression') return false;
+    const sym = this.resolveStdCallee(expr.callee);
+    return sym !== null && sym.module === module && sym.name === name;
+  }
+
+  // Fully qualified runtime name of a std symbol (function, constant or class)
+  private stdQualifiedName(sym: StdSymbol): string {
+    const name = STD_ALIASES[sym.module]?.[sym.name] ?? sym.name;
+    return `ljos::${STD_NAMESPACES[sym.module] ?? sym.module}::${name}`;
+  }
+
+  private generateStdCall(sym: StdSymbol, expr: AST.CallExpression): string {
+    if (sym.module === 'math') {
+      const folded = this.foldMathCall(sym.name, expr);
+      if (folded) return this.constantLiteral(folded);
+    }
+    const cached = this.generateCachedStatQuery(sym, expr);
+    if (cached) return cached;
+    if (sym.module === 'io' && IO_FORMAT_FUNCTIONS.has(sym.name)) {
+      const formatted = this.generateStaticFormatCall(sym, expr);
+      if (formatted) return formatted;
+    }
+    const viewArgs = this.acceptsStringView(sym);
+    const args = expr.arguments.map(a => viewArgs ? this.generateViewExpression(a) : this.generateExpression(a)).join(', ');
+    return `${this.stdQualifiedName(sym)}(${args})`;
+  }
+
+  // ============ String views ============
+  //
+  // A slicing or trimming call whose result is consumed within the same full
+  // expression (compared, printed, parsed, or passed to another string function)
+  // uses the runtime's *View variant, so no temporary std::string is built:
+  //   if (trim(line) == "") ...       ->  if ((ljos::str::trimView(line) == ""sv)) ...
+  //   toInt(substring(row, 0, 4))     ->  ljos::str::toInt(ljos::str::substringView(row, 0, 4))
+  // Temporaries live until the end of the full expression, so the views stay valid.
+
+  private acceptsStringView(sym: StdSymbol): boolean {
+    return (sym.module === 'string' && STRING_VIEW_PARAMS.has(sym.name)) ||
+      (sym.module === 'io' && IO_PRINT_FUNCTIONS.has(sym.name));
+  }
+
+  private stringCallSymbol(call: AST.CallExpression): StdSymbol | null {
+    const sym = this.resolveStdCallee(call.callee);
+    if (sym) return sym;
+    if (call.callee.type === 'Identifier' && IO_BUILTINS.has(call.callee.name)) {
+      return { module: 'io', name: call.callee.name };
+    }
+    return null;
+  }
+
+  // Generate `expr` for a position that only reads a std::string_view
+  private generateViewExpression(expr: AST.Expression): string {
+    if (expr.type === 'CallExpression') {
+      const sym = this.resolveStdCallee(expr.callee);
+      if (sym?.module === 'string' && STRING_VIEW_FUNCTIONS.has(sym.name) && !STRING_SPLIT_FUNCTIONS.has(sym.name)) {
+        return this.generateViewCall(sym, expr);
+      }
+    }
+    // A std::string_view literal points at static storage, so it never dangles and
+    // its length is known at compile time
+    if (expr.type === 'Literal' && typeof expr.value === 'string') {
+      return this.generateLiteral(expr).replace(/s$/, 'sv');
+    }
+    // split(line, ",")[2] -> ljos::str::splitView(line, ","sv)[2]
+    if (expr.type === 'MemberExpression' && expr.computed && expr.object.type === 'CallExpression') {
+      const sym = this.resolveStdCallee(expr.object.callee);
+      if (sym?.module === 'string' && STRING_SPLIT_FUNCTIONS.has(sym.name)) {
+        return `${this.generateViewCall(sym, expr.object)}[${this.generateExpression(expr.property)}]`;
+      }
+    }
+    return this.generateExpression(expr);
+  }
+
+  private generateViewCall(sym: StdSymbol, expr: AST.CallExpression): string {
+    const args = expr.arguments.map(a => this.generateViewExpression(a)).join(', ');
+    return `${this.stdQualifiedName(sym)}View(${args})`;
+  }
+
+  // The string a (possibly nested) view call points into, e.g. `line` for trim(substring(line, 2))
+  private viewSource(expr: AST.Expression): AST.Identifier | null {
+    if (expr.type === 'Identifier') return expr;
+    if (expr.type !== 'CallExpression' || expr.arguments.length === 0) return null;
+    const sym = this.resolveStdCallee(expr.callee);
+    if (sym?.module !== 'string' || !STRING_VIEW_FUNCTIONS.has(sym.name) || STRING_SPLIT_FUNCTIONS.has(sym.name)) return null;
+    return this.viewSource(expr.arguments[0]);
+  }
+
+  // Whether `const name = trim(src)` can hold a view: `src` is a const binding
+  // (declared earlier, so it outlives `name`) and `name` is only compared or
+  // passed to functions taking std::string_view
+  private isViewBinding(name: string, init: AST.Expression): boolean {
+    if (init.type !== 'CallExpression') return false;
+    const source = this.viewSource(init);
+    if (!source || !this.varTypes.get(source.name)?.isConst) return false;
+    return this.isViewOnlyUse(name, this.currentBody);
+  }
+
+  // Whether every use of `name` in `body` is a comparison or an argument that is
+  // taken as std::string_view, so `name` can be declared as a view
+  private isViewOnlyUse(name: string, body: AST.Statement[]): boolean {
+    if (!this.isReadOnlyBinding(name, body)) return false;
+    let viewOnly = true;
+    this.walk(body, (node, parent) => {
+      if (!viewOnly) return false;
+      if (node.type !== 'Identifier' || node.name !== name || !parent) return;
+      if (parent.type === 'CallExpression') {
+        const sym = this.stringCallSymbol(parent);
+        if (!sym || !this.acceptsStringView(sym)) viewOnly = false;
+      } else if (parent.type !== 'BinaryExpression') {
+        viewOnly = false;
+      }
+    });
+    return viewOnly;
+  }
+
+  // ============ Math constant folding ============
+  //
+  // math.gcd(12, 18) -> 6, math.toRadians(30) -> 0.5235987755982988,
+  // math.factorial(10) -> ljos::math::BigInt(3628800LL). Arguments may be number
+  // literals, math constants (math.PI) or other foldable calls.
+
+  private foldMathCall(name: string, expr: AST.CallExpression): MathConstant | null {
+    const folder = Object.prototype.hasOwnProperty.call(MATH_FOLDERS, name) ? MATH_FOLDERS[name] : null;
+    if (!folder || expr.arguments.length !== folder.arity) return null;
+    const args: NumericConstant[] = [];
+    for (const arg of expr.arguments) {
+      const value = this.evaluateMathConstant(arg);
+      if (!value || value.kind === 'bool' || value.kind === 'BigInt') return null;
+      args.push(value);
+    }
+    return folder.fold(args);
+  }
+
+  private evaluateMathConstant(expr: AST.Expression): MathConstant | null {
+    switch (expr.type) {
+      case 'Literal':
+        if (typeof expr.value === 'number') {
+          // Like C++, a decimal literal too large for int is a long long
+          if (!Number.isInteger(expr.value)) return { kind: 'double', value: expr.value };
+          return { kind: expr.value <= INT32_MAX ? 'int' : 'long long', value: expr.value };
+        }
+        return typeof expr.value === 'boolean' ? { kind: 'bool', value: expr.value } : null;
+      case 'UnaryExpression': {
+        const arg = expr.operator === '-' ? this.evaluateMathConstant(expr.argument) : null;
+        if (!arg || arg.kind === 'bool' || arg.kind === 'BigInt') return null;
+        return { kind: arg.kind, value: arg.kind === 'double' ? -arg.value : 0 - arg.value };
+      }
+      case 'Identifier':
+      case 'MemberExpression': {
+        const sym = this.resolveStdCallee(expr);
+        if (sym?.module !== 'math' || !Object.prototype.hasOwnProperty.call(MATH_CONSTANT_VALUES, sym.name)) return null;
+        return { kind: 'double', value: MATH_CONSTANT_VALUES[sym.name] };
+      }
+      case 'CallExpression': {
+        const sym = this.resolveStdCallee(expr.callee);
+        return sym?.module === 'math' ? this.foldMathCall(sym.name, expr) : null;
+      }
+      default:
+        return null;
+    }
+  }
+
+  private constantLiteral(c: MathConstant): string {
+    switch (c.kind) {
+      case 'bool':
+        return c.value ? 'true' : 'false';
+      case 'BigInt':
+        return `ljos::math::BigInt(${c.value}LL)`;
+      case 'long long':
+        return c.value < 0 ? `(${c.value}LL)` : `${c.value}LL`;
+      case 'int':
+        return c.value < 0 ? `(${c.value})` : `${c.value}`;
+      case 'double': {
+        // Shortest round-trip form; keep a '.' so the literal stays a double
+        let text = Object.is(c.value, -0) ? '-0.0' : String(c.value);
+        if (!/[.e]/.test(text)) text += '.0';
+        return c.value < 0 || Object.is(c.value, -0) ? `(${text})` : text;
+      }
+    }
+  }
+
+  // printf("x = %d", x) -> ljos::io::printf_fmt(LJOS_FORMAT("x = %d"), x)
+  // The literal is split into segments at C++ compile time; the placeholder count
+  // is checked here and argument types by static_assert in the runtime.
+  private generateStaticFormatCall(sym: StdSymbol, expr: AST.CallExpression): string | null {
+    const [format, ...rest] = expr.arguments;
+    if (!format || format.type !== 'Literal' || typeof format.value !== 'string') return null;
+
+    const specs = (format.value.match(FORMAT_PLACEHOLDER) ?? []).filter(m => m !== '%%');
+    const callee = expr.callee.type === 'MemberExpression' ? expr.callee.property : expr.callee;
+    const line = callee.type === 'Identifier' ? callee.line ?? 0 : 0;
+    const column = callee.type === 'Identifier' ? callee.column ?? 0 : 0;
+    if (specs.length !== rest.length) {
+      throw new CodegenError(
+        `${sym.name}: format string has ${specs.length} placeholder(s) but ${rest.length} argument(s) were given`,
+        line, column);
+    }
+    rest.forEach((arg, i) => {
+      const numeric = ['%d', '%i', '%f'].includes(specs[i]);
+      if (numeric && (this.isStringLiteral(arg) || (arg.type === 'Literal' && typeof arg.value !== 'number'))) {
+        throw new CodegenError(`${sym.name}: ${specs[i]} expects a number (argument ${i + 1})`, line, column);
+      }
+    });
+
+    // LJOS_FORMAT needs a plain literal, not a std::string
+    const literal = this.generateLiteral(format).replace(/s$/, '');
+    const args = [`LJOS_FORMAT(${literal})`, ...rest.map(a => this.generateExpression(a))];
+    return `${this.stdQualifiedName(sym)}(${args.join(', ')})`;
+  }
+
+  // ============ Metadata query merging ============
+  //
+  // Adjacent statements asking exists/isFile/isDir/fileSize/stat about the same
+  // path share one ljos::fs::stat() call:
+  //   if (isFile(p) && fileSize(p) > 0) ...  ->  const auto _ljos_st0 = ljos::fs::stat(p);
+  //                                             if ((_ljos_st0 && _ljos_st0->isFile) && ...)
+  // A run stops at loops, at any call outside the pure std modules, and at
+  // reassignment of the path variable, so merged answers are never stale. It only
+  // starts at a statement that queries the path at its own level (not just inside
+  // a nested block), so the stat runs where the first query would have run anyway,
+  // and never crosses a statement that declares a variable of the same name.
+
+  // Stable key for a side-effect free path argument
+  private pathKey(expr: AST.Expression | undefined): string | null {
+    if (!expr) return null;
+    if (expr.type === 'Identifier') return `id:${expr.name}`;
+    if (expr.type === 'Literal' && typeof expr.value === 'string') return `str:${expr.value}`;
+    return null;
+  }
+
+  private metadataQueryKey(node: any): string | null {
+    if (node.type !== 'CallExpression' || node.arguments.length !== 1) return null;
+    const sym = this.resolveStdCallee(node.callee);
+    if (!sym || sym.module !== 'fs' || !FS_METADATA_QUERIES.has(sym.name)) return null;
+    return this.pathKey(node.arguments[0]);
+  }
+
+  // Calls that cannot change what a metadata query would return
+  private isFsSafeCall(node: AST.CallExpression): boolean {
+    if (node.callee.type === 'Identifier' && ['println', 'print'].includes(node.callee.name)) return true;
+    const sym = this.resolveStdCallee(node.callee);
+    if (!sym) return false;
+    return FS_SAFE_MODULES.has(sym.module) || (sym.module === 'fs' && FS_READONLY_FUNCTIONS.has(sym.name));
+  }
+
+  // Whether every call from `decl` (or the top-level statement of `body` containing it,
+  // which may be a loop) to the end of `body` is an fs read or a pure std call: no fs
+  // write and no user code that could write or truncate a file
+  private isFsStableAfter(decl: AST.Statement, body: AST.Statement[]): boolean {
+    let start = -1;
+    for (let i = 0; i < body.length && start < 0; i++) {
+      this.walk(body[i], node => {
+        if (start >= 0) return false;
+        if (node === decl) start = i;
+      });
+    }
+    if (start < 0) return false;
+    let stable = true;
+    for (const stmt of body.slice(start)) {
+      this.walk(stmt, node => {
+        if (!stable) return false;
+        if (node.type === 'NewExpression' || (node.type === 'CallExpression' && !this.isFsSafeCall(node))) {
+          stable = false;
+        }
+      });
+    }
+    return stable;
+  }
+
+  // Metadata queries per path in a statement, not counting those inside loops or
+  // closures (they may run after the file changed). Returns null if the statement
+  // contains any call that could modify the file system.
+  private collectStatQueries(stmt: AST.Statement, ownLevel = false): Map<string, number> | null {
+    let unsafe = false;
+    this.walk(stmt, node => {
+      if (unsafe) return false;
+      if (node.type === 'CallExpression' && !this.metadataQueryKey(node) && !this.isFsSafeCall(node)) {
+        unsafe = true;
+      }
+    });
+    if (unsafe) return null;
+
+    const counts = new Map<string, number>();
+    this.walk(stmt, node => {
+      if (node.type === 'WhileStatement' || node.type === 'DoWhileStatement' ||
+          node.type === 'ForStatement' || node.type === 'ArrowFunctionExpression') {
+        return false;
+      }
+      // Own level: the statement's expressions, not its nested blocks or else-ifs
+      if (ownLevel && node !== stmt && (node.type === 'BlockStatement' || node.type === 'IfStatement')) {
+        return false;
+      }
+      const key = this.metadataQueryKey(node);
+      if (key) counts.set(key, (counts.get(key) ?? 0) + 1);
+    });
+    return counts;
+  }
+
+  // Whether `stmt` declares a variable, loop variable or parameter called `name`
+  // anywhere inside it (shadowing the path a merged stat was taken for)
+  private declaresIdentifier(stmt: AST.Statement, name: string): boolean {
+    let declares = false;
+    this.walk(stmt, node => {
+      if ((node.type === 'VariableDeclaration' && node.name === name) ||
+          (node.type === 'ForStatement' && node.variable === name) ||
+          (Array.isArray(node.params) && node.params.some((p: AST.Parameter) => p.name === name))) {
+        declares = true;
+      }
+    });
+    return declares;
+  }
+
+  private assignsIdentifier(stmt: AST.Statement, name: string): boolean {
+    let assigns = false;
+    this.walk(stmt, node => {
+      if (node.type === 'AssignmentExpression' && node.left.type === 'Identifier' && node.left.name === name) {
+        assigns = true;
+      }
+      if (node.type === 'UnaryExpression' && (node.operator === '++' || node.operator === '--') &&
+          node.argument.type === 'Identifier' && node.argument.name === name) {
+        assigns = true;
+      }
+    });
+    return assigns;
+  }
+
+  private generateCachedStatQuery(sym: StdSymbol, expr: AST.CallExpression): string | null {
+    if (sym.module !== 'fs' || !FS_METADATA_QUERIES.has(sym.name) || expr.arguments.length !== 1) return null;
+    const key = this.pathKey(expr.arguments[0]);
+    const temp = key ? this.statCache.get(key) : undefined;
+    if (!temp) return null;
+    switch (sym.name) {
+      case 'exists': return `${temp}.has_value()`;
+      case 'isFile': return `(${temp} && ${temp}->isFile)`;
+      case 'isDir': return `(${temp} && ${temp}->isDir)`;
+      case 'fileSize': return `(${temp} && ${temp}->isFile ? ${temp}->size : -1LL)`;
+      default: return temp;
+    }
+  }
+
+  // Generate a statement list, merging metadata queries across adjacent statements
+  private generateStatements(stmts: AST.Statement[]): string {
+    let code = '';
+    let i = 0;
+    while (i < stmts.length) {
+      const own = this.collectStatQueries(stmts[i], true);
+      const key = own && own.size > 0 ? [...own.keys()][0] : null;
+      const pathName = key?.startsWith('id:') ? key.slice(3) : null;
+      if (!key || (pathName && (this.declaresIdentifier(stmts[i], pathName) ||
+                                this.assignsIdentifier(stmts[i], pathName)))) {
+        code += this.generateStatement(stmts[i]);
+        i++;
+        continue;
+      }
+
+      // Extend the run while following statements query the same path safely
+      let total = this.collectStatQueries(stmts[i])!.get(key)!;
+      let end = i + 1;
+      while (end < stmts.length) {
+        const next = this.collectStatQueries(stmts[end]);
+        if (!next || !next.has(key)) break;
+        if (pathName && (this.assignsIdentifier(stmts[end], pathName) || this.declaresIdentifier(stmts[end], pathName))) break;
+        total += next.get(key)!;
+        end++;
+      }
+
+      if (total < 2 || this.statCache.has(key)) {
+        code += this.generateStatement(stmts[i]);
+        i++;
+        continue;
+      }
+
+      const temp = `_ljos_st${this.tempCounter++}`;
+      const pathExpr = key.startsWith('id:') ? key.slice(3) : this.generateLiteral({ type: 'Literal', value: key.slice(4), raw: '' });
+      code += this.getIndent() + `const auto ${temp} = ljos::fs::stat(${pathExpr});\n`;
+      this.statCache.set(key, temp);
+      for (let k = i; k < end; k++) {
+        code += this.generateStatement(stmts[k]);
+      }
+      this.statCache.delete(key);
+      i = end;
+    }
+    return code;
+  }
+
+  // Loop bodies and closures may observe later file system state: no merged stats inside
+  private withoutStatCache<T>(fn: () => T): T {
+    const saved = this.statCache;
+    this.statCache = new Map();
+    try {
+      return fn();
+    } finally {
+      this.statCache = saved;
+    }
+  }
+
+  // Pre-order walk over AST nodes; return false from `visit` to skip a subtree
+  private walk(node: unknown, visit: (node: any, parent: any) => boolean | void, parent: any = null): void {
+    if (!node || typeof node !== 'object') return;
+    if (Array.isArray(node)) {
+      for (const child of node) this.walk(child, visit, parent);
+      return;
+    }
+    const n = node as any;
+    const isNode = typeof n.type === 'string';
+    if (isNode && visit(n, parent) === false) return;
+    for (const key of Object.keys(n)) {
+      if (key === 'loc' || key === 'typeAnnotation' || key === 'returnType') continue;
+      const child = n[key];
+      if (child && typeof child === 'object') {
+        this.walk(child, visit, isNode ? n : parent);
+      }
+    }
+  }
+
+  // Whether every use of `name` in `body` only reads it in place: member access,
+  // comparisons, conditions or arguments to runtime std calls. Anything that may
+  // copy, store, return or capture the value counts as an escape.
+  private isReadOnlyBinding(name: string, body: AST.Statement[]): boolean {
+    let readOnly = true;
+    this.walk(body, (node, parent) => {
+      if (!readOnly) return false;
+      if (node.type === 'ArrowFunctionExpression') {
+        let captured = false;
+        this.walk(node.body, n => {
+          if (n.type === 'Identifier' && n.name === name) captured = true;
+        });
+        if (captured) readOnly = false;
+        return false;
+      }
+      if (node.type !== 'Identifier' || node.name !== name || !parent) return;
+      switch (parent.type) {
+        case 'MemberExpression':
+          if (parent.object !== node) readOnly = false;
+          break;
+        case 'BinaryExpression':
+          if (!COMPARISON_OPERATORS.has(parent.operator)) readOnly = false;
+          break;
+        case 'UnaryExpression':
+          if (parent.operator !== '!') readOnly = false;
+          break;
+        case 'LogicalExpression':
+        case 'IfStatement':
+        case 'WhileStatement':
+          break;
+        case 'ConditionalExpression':
+        case 'IfExpression':
+          if (parent.test !== node && parent.condition !== node) readOnly = false;
+          break;
+        case 'CallExpression':
+          if (parent.callee === node || !this.resolveStdCallee(parent.callee)) readOnly = false;
+          break;
+        default:
+          readOnly = false;
+      }
+    });
+    return readOnly;
+  }
+
   private getIndent(): string {
     return '    '.repeat(this.indent);
   }
@@ -229,6 +1008,12 @@ export class CppCodeGenerator {
         case 'Nul': return 'nullptr_t';
         case 'Char': return 'char';
         case 'Byte': return 'unsigned char';
+        case 'Bytes':
+          this.includes.add(`#include "${BYTES_RUNTIME_HEADER}"`);
+          return 'ljos::Bytes';
+        case 'BigInt':
+          this.includes.add(`#include "${STD_RUNTIME_HEADERS.math}"`);
+          return 'ljos::math::BigInt';
         
         // C++ style integer types
         case 'short': return 'short';
@@ -242,7 +1027,15 @@ export class CppCodeGenerator {
         case 'unsigned long': return 'unsigned long';
         case 'unsigned long long': return 'unsigned long long';
         
-        // Fixed-width integer types
+        // Fixed-width integer types (std/core.lj I8..U64 and C style names)
+        case 'I8': return 'int8_t';
+        case 'I16': return 'int16_t';
+        case 'I32': return 'int32_t';
+        case 'I64': return 'int64_t';
+        case 'U8': return 'uint8_t';
+        case 'U16': return 'uint16_t';
+        case 'U32': return 'uint32_t';
+        case 'U64': return 'uint64_t';
         case 'int8': return 'int8_t';
         case 'int16': return 'int16_t';
         case 'int32': return 'int32_t';
@@ -260,7 +1053,12 @@ export class CppCodeGenerator {
         case 'size_t': return 'size_t';
         case 'ptrdiff_t': return 'ptrdiff_t';
         
-        default: return type.name; // Class name or other
+        default: {
+          // Classes imported from runtime-backed std modules (e.g. fs.Writer)
+          const sym = this.stdImports.get(type.name);
+          if (sym) return this.stdQualifiedName(sym);
+          return type.name; // Class name or other
+        }
       }
     } else if (type.kind === 'array') {
       return `vector<${this.mapType(type.elementType)}>`;
@@ -326,6 +1124,35 @@ export class CppCodeGenerator {
     // Track variable type
     this.varTypes.set(stmt.name, { cppType, isConst: stmt.kind === 'const' });
     
+    // `const x = readFile(p)` that is only compared or passed to functions taking
+    // std::string_view maps the file instead of copying it. The mapping is live, not a
+    // snapshot, so this needs that nothing can write the file while x is in scope
+    if (stmt.kind === 'const' && !stmt.typeAnnotation && stmt.init &&
+        this.isStdCall(stmt.init, 'fs', 'readFile') &&
+        this.isViewOnlyUse(stmt.name, this.currentBody) &&
+        this.isFsStableAfter(stmt, this.currentBody)) {
+      const args = stmt.init.arguments.map(a => this.generateExpression(a)).join(', ');
+      this.varTypes.set(stmt.name, { cppType: 'ljos::fs::MappedFile', isConst: true });
+      return this.getIndent() + `const auto ${stmt.name} = ljos::fs::mapFile(${args});\n`;
+    }
+    
+    // `const t = trim(line)` that is only compared or read by string functions views `line`
+    if (stmt.kind === 'const' && !stmt.typeAnnotation && stmt.init && this.isViewBinding(stmt.name, stmt.init)) {
+      this.varTypes.set(stmt.name, { cppType: 'std::string_view', isConst: true });
+      return this.getIndent() + `const auto ${stmt.name} = ${this.generateViewExpression(stmt.init)};\n`;
+    }
+    
+    // `const r = math.toRadians(30)` -> `constexpr auto r = 0.5235987755982988;`
+    if (stmt.kind === 'const' && stmt.init?.type === 'CallExpression') {
+      const folded = this.evaluateMathConstant(stmt.init);
+      const literalType = !stmt.typeAnnotation || ['int', 'long long', 'double', 'bool'].includes(cppType);
+      if (folded && folded.kind !== 'BigInt' && literalType) {
+        const declType = stmt.typeAnnotation ? cppType : 'auto';
+        this.varTypes.set(stmt.name, { cppType: stmt.typeAnnotation ? cppType : CONSTANT_CPP_TYPES[folded.kind], isConst: true });
+        return this.getIndent() + `constexpr ${declType} ${stmt.name} = ${this.constantLiteral(folded)};\n`;
+      }
+    }
+    
     if (stmt.init) {
       const init = this.generateExpression(stmt.init);
       // Use auto for type inference when no explicit type
@@ -389,11 +1216,12 @@ export class CppCodeGenerator {
     let code = `${returnType} ${funcName}(${params}) {\n`;
     
     const oldIndent = this.indent;
+    const oldBody = this.currentBody;
     this.indent = 1;
-    for (const bodyStmt of stmt.body.body) {
-      code += this.generateStatement(bodyStmt);
-    }
+    this.currentBody = stmt.body.body;
+    code += this.generateStatements(stmt.body.body);
     this.indent = oldIndent;
+    this.currentBody = oldBody;
     
     code += '}\n';
     return code;
@@ -492,11 +1320,12 @@ export class CppCodeGenerator {
     
     if (method.body) {
       const oldIndent = this.indent;
+      const oldBody = this.currentBody;
       this.indent = 2;
-      for (const bodyStmt of method.body.body) {
-        code += this.generateStatement(bodyStmt);
-      }
+      this.currentBody = method.body.body;
+      code += this.generateStatements(method.body.body);
       this.indent = oldIndent;
+      this.currentBody = oldBody;
     }
     
     code += '    }\n\n';
@@ -571,9 +1400,7 @@ export class CppCodeGenerator {
     let code = this.getIndent() + `if (${this.generateExpression(stmt.condition)}) {\n`;
     
     this.indent++;
-    for (const s of stmt.consequent.body) {
-      code += this.generateStatement(s);
-    }
+    code += this.generateStatements(stmt.consequent.body);
     this.indent--;
     
     if (stmt.alternate) {
@@ -582,9 +1409,7 @@ export class CppCodeGenerator {
       } else {
         code += this.getIndent() + '} else {\n';
         this.indent++;
-        for (const s of stmt.alternate.body) {
-          code += this.generateStatement(s);
-        }
+        code += this.generateStatements(stmt.alternate.body);
         this.indent--;
         code += this.getIndent() + '}\n';
       }
@@ -598,11 +1423,33 @@ export class CppCodeGenerator {
   private generateForStatement(stmt: AST.ForStatement): string {
     if (stmt.isForIn && stmt.variable && stmt.iterable) {
       // Range-based for loop
-      let code = this.getIndent() + `for (auto& ${stmt.variable} : ${this.generateExpression(stmt.iterable)}) {\n`;
-      this.indent++;
-      for (const s of stmt.body.body) {
-        code += this.generateStatement(s);
+      let loopVar = `auto& ${stmt.variable}`;
+      let iterable = '';
+      let prologue = '';
+      if (this.isStdCall(stmt.iterable, 'fs', 'lines')) {
+        // fs.lines() streams through ljos::fs::LineReader; each line is a view into its
+        // buffer and dies with the next read, so it is copied once it can escape the body
+        if (this.isViewOnlyUse(stmt.variable, stmt.body.body)) {
+          loopVar = `std::string_view ${stmt.variable}`;
+          this.varTypes.set(stmt.variable, { cppType: 'std::string_view', isConst: true });
+        } else {
+          const temp = `_ljos_line${this.tempCounter++}`;
+          loopVar = `std::string_view ${temp}`;
+          prologue = `std::string ${stmt.variable}(${temp});\n`;
+          this.varTypes.set(stmt.variable, { cppType: 'std::string', isConst: false });
+        }
+      } else if (this.isLazySplit(stmt)) {
+        // for (f in split(row, "\t")) walks ljos::str::SplitIterator instead of building a vector
+        const split = stmt.iterable as AST.CallExpression;
+        const args = split.arguments.map(a => this.generateViewExpression(a)).join(', ');
+        iterable = `ljos::str::splitIter(${args})`;
+        loopVar = `std::string_view ${stmt.variable}`;
+        this.varTypes.set(stmt.variable, { cppType: 'std::string_view', isConst: true });
       }
+      let code = this.getIndent() + `for (${loopVar} : ${iterable || this.generateExpression(stmt.iterable)}) {\n`;
+      this.indent++;
+      if (prologue) code += this.getIndent() + prologue;
+      code += this.withoutStatCache(() => this.generateStatements(stmt.body.body));
       this.indent--;
       code += this.getIndent() + '}\n';
       return code;
@@ -619,26 +1466,34 @@ export class CppCodeGenerator {
       }
     }
     
-    const cond = stmt.condition ? this.generateExpression(stmt.condition) : 'true';
-    const update = stmt.update ? this.generateExpression(stmt.update) : '';
+    const cond = stmt.condition ? this.withoutStatCache(() => this.generateExpression(stmt.condition!)) : 'true';
+    const update = stmt.update ? this.withoutStatCache(() => this.generateExpression(stmt.update!)) : '';
     
     let code = this.getIndent() + `for (${init}; ${cond}; ${update}) {\n`;
     this.indent++;
-    for (const s of stmt.body.body) {
-      code += this.generateStatement(s);
-    }
+    code += this.withoutStatCache(() => this.generateStatements(stmt.body.body));
     this.indent--;
     code += this.getIndent() + '}\n';
     
     return code;
   }
 
+  // `for (x in split(src, d))` can iterate lazily when `src` (or what a view call
+  // like trim(src) points into) is a variable the loop does not reassign, and `x`
+  // is only compared or read by functions taking std::string_view
+  private isLazySplit(stmt: AST.ForStatement): boolean {
+    const split = stmt.iterable!;
+    if (!this.isStdCall(split, 'string', 'split') || split.arguments.length === 0) return false;
+    const source = this.viewSource(split.arguments[0]);
+    if (!source || this.assignsIdentifier(stmt.body, source.name)) return false;
+    return this.isViewOnlyUse(stmt.variable!, stmt.body.body);
+  }
+
   private generateWhileStatement(stmt: AST.WhileStatement): string {
-    let code = this.getIndent() + `while (${this.generateExpression(stmt.condition)}) {\n`;
+    const cond = this.withoutStatCache(() => this.generateExpression(stmt.condition));
+    let code = this.getIndent() + `while (${cond}) {\n`;
     this.indent++;
-    for (const s of stmt.body.body) {
-      code += this.generateStatement(s);
-    }
+    code += this.withoutStatCache(() => this.generateStatements(stmt.body.body));
     this.indent--;
     code += this.getIndent() + '}\n';
     return code;
@@ -654,9 +1509,7 @@ export class CppCodeGenerator {
   private generateBlockStatement(stmt: AST.BlockStatement): string {
     let code = this.getIndent() + '{\n';
     this.indent++;
-    for (const s of stmt.body) {
-      code += this.generateStatement(s);
-    }
+    code += this.generateStatements(stmt.body);
     this.indent--;
     code += this.getIndent() + '}\n';
     return code;
@@ -671,9 +1524,7 @@ export class CppCodeGenerator {
   private generateTryStatement(stmt: AST.TryStatement): string {
     let code = this.getIndent() + 'try {\n';
     this.indent++;
-    for (const s of stmt.block.body) {
-      code += this.generateStatement(s);
-    }
+    code += this.generateStatements(stmt.block.body);
     this.indent--;
     code += this.getIndent() + '}';
     
@@ -685,9 +1536,7 @@ export class CppCodeGenerator {
         code += ` catch (...) {\n`;
       }
       this.indent++;
-      for (const s of handler.body.body) {
-        code += this.generateStatement(s);
-      }
+      code += this.generateStatements(handler.body.body);
       this.indent--;
       code += this.getIndent() + '}';
     }
@@ -716,9 +1565,7 @@ export class CppCodeGenerator {
       
       this.indent++;
       if (c.body.type === 'BlockStatement') {
-        for (const s of c.body.body) {
-          code += this.generateStatement(s);
-        }
+        code += this.generateStatements(c.body.body);
       } else {
         // Expression body
         code += this.getIndent() + this.generateExpression(c.body) + ';\n';
@@ -809,6 +1656,15 @@ export class CppCodeGenerator {
         return this.generateConditionalExpression(expr);
       case 'IfExpression':
         return this.generateIfExpression(expr);
+      case 'AwaitExpression': {
+        // Async std calls return std::shared_future; await blocks on the result
+        const future = this.generateExpression(expr.argument);
+        const simple = ['Identifier', 'CallExpression', 'MemberExpression'].includes(expr.argument.type);
+        return simple ? `${future}.get()` : `(${future}).get()`;
+      }
+      case 'TypeCastExpression':
+        // x of I8 -> static_cast<int8_t>(x)
+        return `static_cast<${this.mapType(expr.typeAnnotation)}>(${this.generateExpression(expr.expression)})`;
       default:
         return `/* TODO: ${expr.type} */`;
     }
@@ -853,10 +1709,19 @@ export class CppCodeGenerator {
     if (expr.name === 'main') {
       return '_ljos_main';
     }
+    // Std constants such as SYNC_ON_CLOSE live in the runtime namespace
+    const sym = this.stdImports.get(expr.name);
+    if (sym) {
+      return this.stdQualifiedName(sym);
+    }
     return expr.name;
   }
 
   private generateBinaryExpression(expr: AST.BinaryExpression): string {
+    if (COMPARISON_OPERATORS.has(expr.operator)) {
+      return `(${this.generateViewExpression(expr.left)} ${expr.operator} ${this.generateViewExpression(expr.right)})`;
+    }
+    
     const left = this.generateExpression(expr.left);
     const right = this.generateExpression(expr.right);
     
@@ -889,10 +1754,6 @@ export class CppCodeGenerator {
     return false;
   }
 
-  private isNumericLiteral(expr: AST.Expression): boolean {
-    return expr.type === 'Literal' && typeof expr.value === 'number';
-  }
-
   // Wrap expression for string concatenation - use to_string for non-string types
   private wrapForStringConcat(expr: AST.Expression, generated: string): string {
     // String literals don't need wrapping
@@ -917,7 +1778,7 @@ export class CppCodeGenerator {
         }
       }
       // For other calls, assume they might return non-string, wrap to be safe
-      return `to_string(${generated})`;
+      return this.fmtToString(generated);
     }
     // Member expressions - check if accessing a string property
     if (expr.type === 'MemberExpression') {
@@ -925,7 +1786,14 @@ export class CppCodeGenerator {
       return generated;
     }
     // Other expressions - wrap with to_string
-    return `to_string(${generated})`;
+    return this.fmtToString(generated);
+  }
+
+  // ljos::fmt::toString formats numbers in their shortest round-trip form
+  // (2.5 -> "2.5", not std::to_string's "2.500000") and passes strings through
+  private fmtToString(generated: string): string {
+    this.includes.add(`#include "${FMT_RUNTIME_HEADER}"`);
+    return `ljos::fmt::toString(${generated})`;
   }
 
   private generateUnaryExpression(expr: AST.UnaryExpression): string {
@@ -939,79 +1807,27 @@ export class CppCodeGenerator {
   }
 
   private generateCallExpression(expr: AST.CallExpression): string {
-    const args = expr.arguments.map(a => this.generateExpression(a)).join(', ');
+    const stdSym = this.resolveStdCallee(expr.callee);
+    if (stdSym) {
+      return this.generateStdCall(stdSym, expr);
+    }
+    
+    const batch = this.generateBatchMap(expr);
+    if (batch) return batch;
     
     // Handle special standard library functions
     if (expr.callee.type === 'Identifier') {
       const name = expr.callee.name;
       
-      // Map println/print to printf (from /std/io)
-      if (name === 'println') {
-        if (expr.arguments.length === 0) {
-          return 'printf("\\n")';
-        }
-        // For single argument, use appropriate format
-        if (expr.arguments.length === 1) {
-          const arg = expr.arguments[0];
-          const argStr = this.generateExpression(arg);
-          // Determine format based on argument type
-          if (this.isStringLiteral(arg) || arg.type === 'Identifier') {
-            // String - use %s format, need .c_str() for std::string
-            return `printf("%s\\n", (${argStr}).c_str())`;
-          } else if (this.isNumericLiteral(arg)) {
-            // Number literal
-            if (Number.isInteger((arg as AST.Literal).value as number)) {
-              return `printf("%d\\n", ${argStr})`;
-            }
-            return `printf("%g\\n", ${argStr})`;
-          } else if (arg.type === 'CallExpression') {
-            // Function call - assume returns string
-            return `printf("%s\\n", (${argStr}).c_str())`;
-          } else {
-            // Default to string
-            return `printf("%s\\n", to_string(${argStr}).c_str())`;
-          }
-        }
-        // Multiple arguments - concatenate as string
-        const argsStr = expr.arguments.map(a => {
-          const gen = this.generateExpression(a);
-          if (this.isStringLiteral(a)) return gen;
-          return `to_string(${gen})`;
-        }).join(' + ');
-        return `printf("%s\\n", (${argsStr}).c_str())`;
-      }
-      if (name === 'print') {
-        if (expr.arguments.length === 0) {
-          return '/* print() */';
-        }
-        if (expr.arguments.length === 1) {
-          const arg = expr.arguments[0];
-          const argStr = this.generateExpression(arg);
-          if (this.isStringLiteral(arg) || arg.type === 'Identifier') {
-            return `printf("%s", (${argStr}).c_str())`;
-          }
-          return `printf("%s", to_string(${argStr}).c_str())`;
-        }
-        const argsStr = expr.arguments.map(a => {
-          const gen = this.generateExpression(a);
-          if (this.isStringLiteral(a)) return gen;
-          return `to_string(${gen})`;
-        }).join(' + ');
-        return `printf("%s", (${argsStr}).c_str())`;
-      }
-      
-      // readln - read line from stdin
-      if (name === 'readln') {
-        this.includes.add('#include <string>');
-        return '[&]() { std::string _line; std::getline(std::cin, _line); return _line; }()';
-      }
-      
-      // readInt - read integer from stdin
-      if (name === 'readInt') {
-        return '[&]() { int _n; std::cin >> _n; return _n; }()';
+      // println/print/readln/... used without importing /std/io
+      if (IO_BUILTINS.has(name)) {
+        this.includes.add(`#include "${STD_RUNTIME_HEADERS.io}"`);
+        return this.generateStdCall({ module: 'io', name }, expr);
       }
     }
     
+    const args = expr.arguments.map(a => this.generateExpression(a)).join(', ');
+    
     // Handle method calls
     if (expr.callee.type === 'MemberExpression') {
       const obj = this.generateExpression(expr.callee.object);
@@ -1026,6 +1842,57 @@ export class CppCodeGenerator {
     return `${callee}(${args})`;
   }
 
+  // arr.map(math.sqrt) / arr.map((x) => math.sqrt(x)) / arr.map((x) => math.pow(x, 2))
+  // -> ljos::math::batch::sqrt(arr) / ljos::math::batch::pow(arr, 2)
+  private generateBatchMap(expr: AST.CallExpression): string | null {
+    const callee = expr.callee;
+    if (callee.type !== 'MemberExpression' || callee.computed ||
+        callee.property.type !== 'Identifier' || callee.property.name !== 'map' ||
+        expr.arguments.length !== 1) {
+      return null;
+    }
+    const fn = expr.arguments[0];
+    
+    const direct = this.resolveStdCallee(fn);
+    if (direct) {
+      if (direct.module !== 'math' || !MATH_BATCH_FUNCTIONS.has(direct.name)) return null;
+      return `ljos::math::batch::${direct.name}(${this.generateExpression(callee.object)})`;
+    }
+    
+    if (fn.type !== 'ArrowFunctionExpression' || fn.params.length !== 1) return null;
+    const param = fn.params[0].name;
+    let body: AST.Expression | undefined;
+    if (fn.body.type === 'BlockStatement') {
+      const only = fn.body.body.length === 1 ? fn.body.body[0] : null;
+      if (only?.type === 'ReturnStatement') body = only.argument;
+    } else {
+      body = fn.body;
+    }
+    if (!body || body.type !== 'CallExpression') return null;
+    
+    const sym = this.resolveStdCallee(body.callee);
+    if (!sym || sym.module !== 'math') return null;
+    const args = body.arguments;
+    const isParam = (e: AST.Expression) => e.type === 'Identifier' && e.name === param;
+    if (MATH_BATCH_FUNCTIONS.has(sym.name) && args.length === 1 && isParam(args[0])) {
+      return `ljos::math::batch::${sym.name}(${this.generateExpression(callee.object)})`;
+    }
+    if (sym.name === 'pow' && args.length === 2 && isParam(args[0]) && !this.mentions(args[1], param)) {
+      const exponent = this.generateExpression(args[1]);
+      return `ljos::math::batch::pow(${this.generateExpression(callee.object)}, ${exponent})`;
+    }
+    return null;
+  }
+
+  private mentions(node: AST.Expression, name: string): boolean {
+    let found = false;
+    this.walk(node, (n) => {
+      if (n.type === 'Identifier' && n.name === name) found = true;
+      return !found;
+    });
+    return found;
+  }
+
   private generateNewExpression(expr: AST.NewExpression): string {
     const callee = this.generateExpression(expr.callee);
     const args = expr.arguments.map(a => this.generateExpression(a)).join(', ');
@@ -1035,6 +1902,12 @@ export class CppCodeGenerator {
   }
 
   private generateMemberExpression(expr: AST.MemberExpression): string {
+    // fs.SYNC_GROUP -> ljos::fs::SYNC_GROUP
+    if (!expr.computed && expr.object.type === 'Identifier' && expr.property.type === 'Identifier') {
+      const module = this.stdNamespaces.get(expr.object.name);
+      if (module) return this.stdQualifiedName({ module, name: expr.property.name });
+    }
+    
     const obj = this.generateExpression(expr.object);
     
     if (expr.computed) {
@@ -1053,6 +1926,13 @@ export class CppCodeGenerator {
   }
 
   private generateObjectExpression(expr: AST.ObjectExpression): string {
+    // { "&" => "&amp;", ... } -> {{"&"s, "&amp;"s}, ...}, which initializes maps and
+    // vectors of pairs (e.g. ljos::str::replaceMany)
+    if (expr.properties.length > 0 && expr.properties.every(p => p.key.type !== 'Identifier')) {
+      const entries = expr.properties.map(p => `{${this.generateExpression(p.key)}, ${this.generateExpression(p.value)}}`);
+      return `{${entries.join(', ')}}`;
+    }
+    
     // For now, generate as initializer list
     const props = expr.properties.map(p => {
       const value = this.generateExpression(p.value);
@@ -1074,25 +1954,22 @@ export class CppCodeGenerator {
           .replace(/\\/g, '\\\\')
           .replace(/"/g, '\\"')
           .replace(/\n/g, '\\n');
-        return `"${escaped}"s`;
+        return `"${escaped}"`;
       }
-      const exprStr = this.generateExpression(part);
-      // Only wrap in to_string if it's a numeric literal
-      // Identifiers and other expressions are assumed to be strings in template context
-      if (this.isNumericLiteral(part)) {
-        return `to_string(${exprStr})`;
-      }
-      return exprStr;
+      return this.generateExpression(part);
     });
     
     if (parts.length === 0) {
       return '""s';
     }
-    if (parts.length === 1) {
-      return parts[0];
+    if (parts.length === 1 && typeof expr.parts[0] === 'string') {
+      return `${parts[0]}s`;
     }
     
-    return parts.join(' + ');
+    // ljos::fmt::concat reserves the result once and formats each value
+    // (strings, numbers, bools) straight into it - no per-part temporaries
+    this.includes.add(`#include "${FMT_RUNTIME_HEADER}"`);
+    return `ljos::fmt::concat(${parts.join(', ')})`;
   }
 
   private generateTypeofExpression(expr: AST.TypeofExpression): string {
@@ -1102,6 +1979,10 @@ export class CppCodeGenerator {
   }
 
   private generateArrowFunction(expr: AST.ArrowFunctionExpression): string {
+    return this.withoutStatCache(() => this.generateArrowFunctionBody(expr));
+  }
+
+  private generateArrowFunctionBody(expr: AST.ArrowFunctionExpression): string {
     const params = expr.params.map(p => {
       const pType = this.mapType(p.typeAnnotation);
       return `${pType} ${p.name}`;
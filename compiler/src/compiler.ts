@@ -3,7 +3,7 @@ import * as path from 'node:path';
 import { Lexer, LexerError } from './lexer';
 import { Parser, ParserError } from './parser';
 import { CodeGenerator } from './codegen';
-import { CppCodeGenerator } from './codegen_cpp';
+import { CppCodeGenerator, CodegenError } from './codegen_cpp';
 import { Program } from './ast';
 import { TypeChecker } from './typechecker';
 import { CompilerOptions } from './config';
@@ -164,6 +164,13 @@ export class Compiler {
           column: error.token.column,
           file: filename,
         });
+      } else if (error instanceof CodegenError) {
+        errors.push({
+          message: error.message,
+          line: error.line,
+          column: error.column,
+          file: filename,
+        });
       } else if (error instanceof Error) {
         errors.push({
           message: error.message,
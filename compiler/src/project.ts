@@ -282,8 +282,10 @@ export class ProjectCompiler {
     // Copy runtime/std to output directory for JS target
     if (this.config.compilerOptions?.codegenTarget !== 'c') {
         this.copyRuntimeStd();
+    } else {
+        // C++ target only needs the header-only native runtime (runtime/std/cpp)
+        this.copyRuntimeStd('cpp');
     }
-    // C++ target generates native code, no runtime needed
 
     result.ljcDuration = Date.now() - startTime;
     result.duration = result.ljcDuration;
@@ -340,22 +342,22 @@ export class ProjectCompiler {
   }
 
   /**
-   * Copy runtime/std directory to output directory
+   * Copy runtime/std directory (or one of its subdirectories) to output directory
    */
-  private copyRuntimeStd(): void {
+  private copyRuntimeStd(subDir: string = ''): void {
     const outDir = this.config.compilerOptions?.outDir || './dist';
     const rootDir = this.config.compilerOptions?.rootDir || './src';
     
     // Runtime std is relative to the compiler installation
     const compilerDir = path.dirname(__dirname);
-    const runtimeStdSrc = path.join(compilerDir, 'runtime', 'std');
+    const runtimeStdSrc = path.join(compilerDir, 'runtime', 'std', subDir);
     
     // Destination is outDir/rootDir/runtime/std (to match import paths)
-    const runtimeStdDest = path.join(this.projectRoot, outDir, rootDir, 'runtime', 'std');
+    const runtimeStdDest = path.join(this.projectRoot, outDir, rootDir, 'runtime', 'std', subDir);
     
     if (!fs.existsSync(runtimeStdSrc)) {
       // Try alternative location (when running from src with ts-node)
-      const altSrc = path.join(compilerDir, '..', 'runtime', 'std');
+      const altSrc = path.join(compilerDir, '..', 'runtime', 'std', subDir);
       if (fs.existsSync(altSrc)) {
         this.copyDirRecursive(altSrc, runtimeStdDest);
       }
@@ -559,6 +561,11 @@ export class ProjectCompiler {
         extraArgs += ' -std=c++17';
     }
     
+    // The native runtime uses std::thread (e.g. fs.copyTree)
+    if (hasCpp && os.platform() !== 'win32') {
+        extraArgs += ' -pthread';
+    }
+    
     // Add size optimization flags
     extraArgs += ' -s';                    // Strip symbols
     extraArgs += ' -ffunction-sections';   // Put each function in its own section
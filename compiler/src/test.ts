@@ -0,0 +1,151 @@
+/**
+ * Native backend tests
+ *
+ * Every test/cpp/*.lj is compiled to C++, built with g++ against the header-only
+ * runtime (runtime/std/cpp) and run; its stdout must equal the matching .expected
+ * file. If a matching .stdin file exists the program runs twice, once reading it as a
+ * regular file and once through a pipe, and both runs must print the expected output.
+ * If a matching .stderr file exists, stderr must equal it as well, with log timestamps
+ * ("2026-01-02 15:04:05.123") replaced by <time>. Lines of the form
+ *   # expect-cpp: <text>       the generated C++ must contain <text>
+ *   # expect-no-cpp: <text>    the generated C++ must not contain <text>
+ * pin the lowering a test is about, not just the program's output.
+ *
+ * Usage: npm test [-- <name filter>]   (CXX overrides the compiler, default g++)
+ */
+
+import * as fs from 'node:fs';
+import * as os from 'node:os';
+import * as path from 'node:path';
+import { execFileSync, spawnSync } from 'node:child_process';
+import { Compiler } from './compiler';
+
+const compilerRoot = process.env.LJOS_COMPILER_ROOT ?? path.resolve(__dirname, '..');
+const testDir = path.join(compilerRoot, 'test', 'cpp');
+const cxx = process.env.CXX ?? 'g++';
+const filter = process.argv[2] ?? '';
+
+interface Expectations {
+  contains: string[];
+  excludes: string[];
+}
+
+function readExpectations(source: string): Expectations {
+  const contains: string[] = [];
+  const excludes: string[] = [];
+  for (const line of source.split('\n')) {
+    const match = /^#\s*expect-(no-)?cpp:\s*(.*?)\s*$/.exec(line);
+    if (!match) continue;
+    (match[1] ? excludes : contains).push(match[2]);
+  }
+  return { contains, excludes };
+}
+
+// Returns null on success, otherwise a description of the failure
+function runTest(name: string, buildDir: string): string | null {
+  const source = fs.readFileSync(path.join(testDir, `${name}.lj`), 'utf-8');
+  const expectedFile = path.join(testDir, `${name}.expected`);
+
+  const result = new Compiler({ codegenTarget: 'c' }).compile(source, undefined, true);
+  if (!result.success || !result.code) {
+    return result.errors.map(e => `${e.line}:${e.column}: ${e.message}`).join('\n');
+  }
+
+  const { contains, excludes } = readExpectations(source);
+  for (const text of contains) {
+    if (!result.code.includes(text)) return `generated C++ does not contain: ${text}`;
+  }
+  for (const text of excludes) {
+    if (result.code.includes(text)) return `generated C++ unexpectedly contains: ${text}`;
+  }
+
+  const cppFile = path.join(buildDir, `${name}.cpp`);
+  const exeFile = path.join(buildDir, name);
+  fs.writeFileSync(cppFile, result.code);
+  try {
+    execFileSync(cxx, ['-std=c++17', '-O1', '-pthread', '-I', buildDir, cppFile, '-o', exeFile], { stdio: 'pipe' });
+  } catch (e: any) {
+    return `${cxx} failed:\n${e.stderr?.toString() ?? e.message}`;
+  }
+
+  const stdinFile = path.join(testDir, `${name}.stdin`);
+  const stderrFile = path.join(testDir, `${name}.stderr`);
+  const inputs = fs.existsSync(stdinFile) ? ['file', 'pipe'] as const : ['none'] as const;
+  for (const input of inputs) {
+    const run = runProgram(exeFile, buildDir, input, stdinFile);
+    if (run.status !== 0) {
+      return `program exited with status ${run.status ?? run.signal}:\n${run.stderr}`;
+    }
+    if (!fs.existsSync(expectedFile)) {
+      return `missing ${name}.expected; the program printed:\n${run.stdout}`;
+    }
+    const via = input === 'none' ? '' : ` (stdin from ${input})`;
+    const expected = fs.readFileSync(expectedFile, 'utf-8');
+    if (run.stdout !== expected) {
+      return `output differs${via}\n--- expected\n${expected}--- actual\n${run.stdout}`;
+    }
+    if (fs.existsSync(stderrFile)) {
+      const expectedErr = fs.readFileSync(stderrFile, 'utf-8');
+      const stderr = run.stderr.replace(/\d{4}-\d\d-\d\d \d\d:\d\d:\d\d\.\d{3}/g, '<time>');
+      if (stderr !== expectedErr) {
+        return `stderr differs${via}\n--- expected\n${expectedErr}--- actual\n${stderr}`;
+      }
+    }
+  }
+  return null;
+}
+
+interface RunResult {
+  status: number | null;
+  signal: string | null;
+  stdout: string;
+  stderr: string;
+}
+
+function runProgram(exeFile: string, buildDir: string, input: 'none' | 'file' | 'pipe', stdinFile: string): RunResult {
+  const fd = input === 'file' ? fs.openSync(stdinFile, 'r') : input === 'pipe' ? 'pipe' : 'ignore';
+  try {
+    const result = spawnSync(exeFile, [], {
+      cwd: buildDir,
+      input: input === 'pipe' ? fs.readFileSync(stdinFile) : undefined,
+      stdio: [fd, 'pipe', 'pipe'],
+      maxBuffer: 64 * 1024 * 1024,
+    });
+    if (result.error) throw result.error;
+    return { status: result.status, signal: result.signal, stdout: result.stdout.toString(), stderr: result.stderr.toString() };
+  } finally {
+    if (typeof fd === 'number') fs.closeSync(fd);
+  }
+}
+
+function main(): void {
+  const names = fs.readdirSync(testDir)
+    .filter(f => f.endsWith('.lj'))
+    .map(f => f.slice(0, -3))
+    .filter(n => n.includes(filter))
+    .sort();
+
+  // Generated sources include "runtime/std/cpp/*.hpp" relative to the build directory
+  const buildDir = fs.mkdtempSync(path.join(os.tmpdir(), 'ljos-test-'));
+  fs.cpSync(path.join(compilerRoot, 'runtime', 'std', 'cpp'), path.join(buildDir, 'runtime', 'std', 'cpp'), { recursive: true });
+
+  let failed = 0;
+  try {
+    for (const name of names) {
+      const error = runTest(name, buildDir);
+      if (error) {
+        failed++;
+        console.log(`FAIL ${name}\n${error.replace(/^/gm, '    ')}`);
+      } else {
+        console.log(`ok   ${name}`);
+      }
+    }
+  } finally {
+    fs.rmSync(buildDir, { recursive: true, force: true });
+  }
+
+  console.log(`\n${names.length - failed}/${names.length} passed`);
+  if (failed > 0) process.exit(1);
+}
+
+main();
@@ -37,7 +37,7 @@ interface Scope {
 // 隐式类型转换规则：定义哪些类型可以隐式转换为其他类型
 const IMPLICIT_CONVERSIONS: Map<string, Set<string>> = new Map([
   // 数值类型转换
-  ['Int', new Set(['Float', 'Num', 'long', 'long long'])],      // Int -> Float, Int -> Num
+  ['Int', new Set(['Float', 'Num', 'BigInt', 'long', 'long long'])], // Int -> Float, Int -> Num, Int -> BigInt
   ['Float', new Set(['Num', 'double'])],              // Float -> Num
   ['Byte', new Set(['Int', 'Float', 'Num', 'short', 'int'])], // Byte -> Int -> Float -> Num
   // 字符类型转换
@@ -55,6 +55,12 @@ const IMPLICIT_CONVERSIONS: Map<string, Set<string>> = new Map([
   ['float', new Set(['double', 'Float'])],
 ]);
 
+// std/core.lj 的定宽整数类型名，按对应的 C++ 风格类型检查转换
+const FIXED_WIDTH_ALIASES: Map<string, string> = new Map([
+  ['I8', 'int8'], ['I16', 'int16'], ['I32', 'int32'], ['I64', 'int64'],
+  ['U8', 'uint8'], ['U16', 'uint16'], ['U32', 'uint32'], ['U64', 'uint64'],
+]);
+
 // 显式类型转换规则：定义哪些类型可以显式转换
 const EXPLICIT_CONVERSIONS: Map<string, Set<string>> = new Map([
   // 数值类型之间可以显式转换
@@ -225,7 +231,7 @@ export class TypeChecker {
       if (classType) return classType;
       
       // Primitive types
-      return { kind: 'primitive', name: annotation.name };
+      return { kind: 'primitive', name: FIXED_WIDTH_ALIASES.get(annotation.name) ?? annotation.name };
     }
     
     if (annotation.kind === 'array') {
@@ -346,6 +352,14 @@ export class TypeChecker {
         if (stmt.alternate) this.checkStatement(stmt.alternate as Statement, scope, filename, errors);
         break;
       case 'ForStatement':
+        if (stmt.isForIn && stmt.variable) {
+          // for (x in iterable): x is only visible in the body
+          if (stmt.iterable) this.checkExpression(stmt.iterable, scope, filename, errors);
+          const loopScope: Scope = { parent: scope, symbols: new Map() };
+          loopScope.symbols.set(stmt.variable, { type: { kind: 'unknown' } });
+          this.checkStatement(stmt.body, loopScope, filename, errors);
+          break;
+        }
         if (stmt.init && 'type' in stmt.init) {
           this.checkStatement(stmt.init as Statement, scope, filename, errors);
         }